@@ -0,0 +1,1303 @@
+/** mockcli.c
+ *   A stand-in for the DB2 CLI library (libdb2.so) that implements the
+ *   functions db2_fdw calls, so that db2_fdw can be run and measured
+ *   without a DB2 server.  All tables are synthetic, their rows are
+ *   generated on the fly and whatever is written to them is discarded.
+ *
+ *   The behaviour is set with environment variables of the PostgreSQL
+ *   server:
+ *
+ *   MOCKCLI_COLUMNS     columns of every table as "NAME TYPE, ..."
+ *                       (SMALLINT, INTEGER, BIGINT, DECIMAL(p,s), REAL,
+ *                       DOUBLE, DECFLOAT, CHAR(n), VARCHAR(n), CLOB(n),
+ *                       BLOB(n), DATE, TIME, TIMESTAMP, BOOLEAN)
+ *   MOCKCLI_COLUMNS_<T> columns of table <T> (upper case name)
+ *   MOCKCLI_ROWS        number of rows of every table
+ *   MOCKCLI_ROWS_<T>    number of rows of table <T>
+ *   MOCKCLI_LOB_SIZE    length of CLOB and BLOB values in bytes
+ *   MOCKCLI_NULL_EVERY  every n-th value of a column other than the first is NULL
+ *   MOCKCLI_LATENCY_US  time of one round trip to the server in microseconds
+ *   MOCKCLI_BLOCK_ROWS  rows per round trip of a fetch, unless the statement
+ *                       sets SQL_ATTR_PREFETCH_NROWS
+ *
+ *   A round trip is made by connecting, preparing, executing, ending a
+ *   transaction, pinging, every block of fetched rows and every SQLGetData
+ *   call.  A round trip can be interrupted by SQLCancel.
+ *   WHERE conditions are not evaluated, a query returns all rows of the
+ *   table (or as many as FETCH FIRST allows), and every INSERT, UPDATE or
+ *   DELETE processes exactly one row.  Expressions in the SELECT list
+ *   return the string "1".
+ */
+#include <ctype.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * The prototypes in sqlcli1.h differ in details between DB2 releases, so
+ * they are renamed here and the functions below are defined with their own
+ * (binary compatible) signatures.  The types still come from sqlcli1.h,
+ * so SQLLEN has the same size as in db2_fdw.
+ */
+#define SQLAllocHandle   mockcli_SQLAllocHandle
+#define SQLBindCol       mockcli_SQLBindCol
+#define SQLBindParameter mockcli_SQLBindParameter
+#define SQLCancel        mockcli_SQLCancel
+#define SQLColAttribute  mockcli_SQLColAttribute
+#define SQLConnect       mockcli_SQLConnect
+#define SQLDescribeCol   mockcli_SQLDescribeCol
+#define SQLDisconnect    mockcli_SQLDisconnect
+#define SQLDriverConnect mockcli_SQLDriverConnect
+#define SQLEndTran       mockcli_SQLEndTran
+#define SQLExecDirect    mockcli_SQLExecDirect
+#define SQLExecute       mockcli_SQLExecute
+#define SQLFetch         mockcli_SQLFetch
+#define SQLFetchScroll   mockcli_SQLFetchScroll
+#define SQLFreeHandle    mockcli_SQLFreeHandle
+#define SQLFreeStmt      mockcli_SQLFreeStmt
+#define SQLGetConnectAttr mockcli_SQLGetConnectAttr
+#define SQLGetCursorName mockcli_SQLGetCursorName
+#define SQLGetData       mockcli_SQLGetData
+#define SQLGetDiagRec    mockcli_SQLGetDiagRec
+#define SQLGetInfo       mockcli_SQLGetInfo
+#define SQLNumResultCols mockcli_SQLNumResultCols
+#define SQLParamData     mockcli_SQLParamData
+#define SQLPrepare       mockcli_SQLPrepare
+#define SQLPutData       mockcli_SQLPutData
+#define SQLRowCount      mockcli_SQLRowCount
+#define SQLSetConnectAttr mockcli_SQLSetConnectAttr
+#define SQLSetEnvAttr    mockcli_SQLSetEnvAttr
+#define SQLSetStmtAttr   mockcli_SQLSetStmtAttr
+#include <sqlcli1.h>
+#undef SQLAllocHandle
+#undef SQLBindCol
+#undef SQLBindParameter
+#undef SQLCancel
+#undef SQLColAttribute
+#undef SQLConnect
+#undef SQLDescribeCol
+#undef SQLDisconnect
+#undef SQLDriverConnect
+#undef SQLEndTran
+#undef SQLExecDirect
+#undef SQLExecute
+#undef SQLFetch
+#undef SQLFetchScroll
+#undef SQLFreeHandle
+#undef SQLFreeStmt
+#undef SQLGetConnectAttr
+#undef SQLGetCursorName
+#undef SQLGetData
+#undef SQLGetDiagRec
+#undef SQLGetInfo
+#undef SQLNumResultCols
+#undef SQLParamData
+#undef SQLPrepare
+#undef SQLPutData
+#undef SQLRowCount
+#undef SQLSetConnectAttr
+#undef SQLSetEnvAttr
+#undef SQLSetStmtAttr
+
+#define MOCK_MAX_COLS     256
+#define MOCK_MAX_PARAMS   256
+#define MOCK_NAME_LEN     129
+#define MOCK_PATTERN_LEN  4096
+#define MOCK_VERSION      "11.05.0900"
+
+typedef enum { MOCK_ENV = 1, MOCK_DBC, MOCK_STMT } MockKind;
+
+/** a column of a synthetic table */
+typedef struct {
+  char         name[MOCK_NAME_LEN];
+  SQLSMALLINT  sqltype;
+  SQLULEN      size;                     /* precision or length in characters  */
+  SQLSMALLINT  scale;
+  SQLLEN       octets;                   /* length in bytes                    */
+  SQLINTEGER   codepage;                 /* 0 for numbers and binary data      */
+} MockColumn;
+
+/** a buffer bound with SQLBindCol or SQLBindParameter */
+typedef struct {
+  SQLSMALLINT  ctype;
+  SQLPOINTER   value;
+  SQLLEN       buflen;
+  SQLLEN*      ind;
+} MockBinding;
+
+/** environment, connection and statement handles */
+typedef struct MockHandle {
+  MockKind     kind;
+  char         sqlstate[6];              /* diagnostics of the last call       */
+  SQLINTEGER   native;
+  char         message[512];
+  int          has_diag;
+  volatile int busy;                     /* in a round trip                    */
+  volatile int cancel;                   /* SQLCancel during the round trip    */
+  /* statement only */
+  int          prepared;
+  int          is_select;
+  int          is_dml;
+  long         rows;                     /* rows of the result set             */
+  long         row;                      /* current row, -1 before the first   */
+  long         block;                    /* rows per round trip, 0 for default */
+  SQLLEN       rowcount;
+  int          ncols;                    /* columns of the table               */
+  MockColumn   cols[MOCK_MAX_COLS];
+  int          nresult;                  /* columns of the result set          */
+  int          result[MOCK_MAX_COLS];    /* table column, -1 for an expression */
+  MockBinding  bound[MOCK_MAX_COLS];
+  int          markers;                  /* parameter markers in the statement */
+  int          nparams;
+  MockBinding  params[MOCK_MAX_PARAMS];
+  int          need_data;                /* SQLExecute returned SQL_NEED_DATA  */
+  int          dae_param;                /* data-at-exec parameter being sent  */
+  int          getdata_col;              /* column and offset of SQLGetData    */
+  SQLLEN       getdata_off;
+  unsigned long checksum;                /* of all parameter data received     */
+} MockHandle;
+
+/** configuration, read once */
+static pthread_once_t mockOnce        = PTHREAD_ONCE_INIT;
+static long           mockLatencyUs   = 0;
+static long           mockBlockRows   = 100;
+static long           mockLobSize     = 4096;
+static long           mockNullEvery   = 0;
+static long           mockDefaultRows = 10000;
+static char           mockPattern[MOCK_PATTERN_LEN + 26];
+static unsigned long  mockCursors     = 0;
+
+static const char*    mockDefaultColumns = "ID INTEGER, AMOUNT DECIMAL(15,2), NAME VARCHAR(100), CREATED TIMESTAMP";
+
+/** local prototypes */
+static void           mockInit          (void);
+static long           mockEnvLong       (const char* name, long dflt);
+static SQLRETURN      mockDiag          (MockHandle* h, const char* sqlstate, SQLINTEGER native, const char* fmt, ...);
+static SQLRETURN      mockRoundTrip     (MockHandle* h);
+static const char*    mockKeyword       (const char* sql, const char* kw);
+static void           mockTableName     (const char* p, char* name);
+static int            mockParseColumns  (MockHandle* h, const char* spec);
+static int            mockParseType     (MockColumn* col, const char* type);
+static void           mockParseResult   (MockHandle* h, const char* list, const char* end);
+static SQLRETURN      mockParse         (MockHandle* h, const char* sql, SQLINTEGER len);
+static SQLLEN         mockValue         (MockHandle* h, int rcol, long row, char* tmp, size_t tmpsize, int* pattern);
+static void           mockCopy          (int pattern, const char* tmp, long row, SQLLEN off, char* dst, SQLLEN n);
+static SQLRETURN      mockPut           (MockHandle* h, int rcol, MockBinding* b);
+static void           mockReadParams    (MockHandle* h);
+static SQLRETURN      mockExecuted      (MockHandle* h);
+static void           mockString        (const char* src, SQLCHAR* dst, SQLSMALLINT max, SQLSMALLINT* len);
+
+/** mockInit
+ *   Read the configuration and build the pattern that string values are cut from.
+ */
+static void mockInit (void) {
+  int i;
+
+  mockLatencyUs   = mockEnvLong ("MOCKCLI_LATENCY_US", 0);
+  mockBlockRows   = mockEnvLong ("MOCKCLI_BLOCK_ROWS", 100);
+  mockLobSize     = mockEnvLong ("MOCKCLI_LOB_SIZE", 4096);
+  mockNullEvery   = mockEnvLong ("MOCKCLI_NULL_EVERY", 0);
+  mockDefaultRows = mockEnvLong ("MOCKCLI_ROWS", 10000);
+  if (mockBlockRows < 1)
+    mockBlockRows = 1;
+  for (i = 0; i < (int) sizeof (mockPattern); ++i)
+    mockPattern[i] = 'a' + i % 26;
+}
+
+/** mockEnvLong
+ *   The value of a numeric environment variable.
+ */
+static long mockEnvLong (const char* name, long dflt) {
+  const char* value = getenv (name);
+
+  return (value != NULL && *value != '\0') ? strtol (value, NULL, 10) : dflt;
+}
+
+/** mockDiag
+ *   Set the diagnostic record of a handle, returns SQL_ERROR.
+ */
+static SQLRETURN mockDiag (MockHandle* h, const char* sqlstate, SQLINTEGER native, const char* fmt, ...) {
+  char    text[400];
+  va_list args;
+
+  va_start (args, fmt);
+  vsnprintf (text, sizeof (text), fmt, args);
+  va_end (args);
+  snprintf (h->sqlstate, sizeof (h->sqlstate), "%s", sqlstate);
+  h->native = native;
+  snprintf (h->message, sizeof (h->message), "[IBM][CLI Driver] SQL%04dN  %s  SQLSTATE=%s", (int) (native < 0 ? -native : native), text, sqlstate);
+  h->has_diag = 1;
+  return SQL_ERROR;
+}
+
+/** mockRoundTrip
+ *   Wait for the configured latency, unless SQLCancel interrupts it.
+ */
+static SQLRETURN mockRoundTrip (MockHandle* h) {
+  struct timespec now;
+  struct timespec deadline;
+  struct timespec pause;
+  long            left;
+
+  if (mockLatencyUs <= 0)
+    return SQL_SUCCESS;
+  clock_gettime (CLOCK_MONOTONIC, &deadline);
+  deadline.tv_sec  += mockLatencyUs / 1000000;
+  deadline.tv_nsec += (mockLatencyUs % 1000000) * 1000;
+  if (deadline.tv_nsec >= 1000000000) {
+    deadline.tv_sec  += 1;
+    deadline.tv_nsec -= 1000000000;
+  }
+  h->cancel = 0;
+  h->busy   = 1;
+  for (;;) {
+    if (h->cancel) {
+      h->busy   = 0;
+      h->cancel = 0;
+      return mockDiag (h, "57014", -952, "Processing was cancelled due to an interrupt.");
+    }
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    left = (deadline.tv_sec - now.tv_sec) * 1000000000L + (deadline.tv_nsec - now.tv_nsec);
+    if (left <= 0)
+      break;
+    /* sleep in slices, so that a cancel request is noticed quickly */
+    pause.tv_sec  = 0;
+    pause.tv_nsec = (left < 1000000L) ? left : 1000000L;
+    nanosleep (&pause, NULL);
+  }
+  h->busy = 0;
+  return SQL_SUCCESS;
+}
+
+/** mockKeyword
+ *   Find a keyword outside of parentheses and quotes, case insensitive.
+ *   Returns a pointer to the keyword or NULL.
+ */
+static const char* mockKeyword (const char* sql, const char* kw) {
+  size_t      len   = strlen (kw);
+  int         depth = 0;
+  char        quote = '\0';
+  const char* p;
+
+  for (p = sql; *p != '\0'; ++p) {
+    if (quote != '\0') {
+      if (*p == quote)
+        quote = '\0';
+      continue;
+    }
+    if (*p == '\'' || *p == '"') {
+      quote = *p;
+    } else if (*p == '(') {
+      ++depth;
+    } else if (*p == ')') {
+      --depth;
+    } else if (depth == 0 && strncasecmp (p, kw, len) == 0
+               && (p == sql || !(isalnum ((unsigned char) p[-1]) || p[-1] == '_'))
+               && !(isalnum ((unsigned char) p[len]) || p[len] == '_')) {
+      return p;
+    }
+  }
+  return NULL;
+}
+
+/** mockTableName
+ *   Copy the unqualified, unquoted table name at p in upper case.
+ */
+static void mockTableName (const char* p, char* name) {
+  int n = 0;
+
+  name[0] = '\0';
+  while (*p == ' ' || *p == '\t' || *p == '\n')
+    ++p;
+  for (;;) {
+    n = 0;
+    if (*p == '"') {
+      for (++p; *p != '\0' && *p != '"' && n < MOCK_NAME_LEN - 1; ++p)
+        name[n++] = toupper ((unsigned char) *p);
+      if (*p == '"')
+        ++p;
+    } else {
+      for (; (isalnum ((unsigned char) *p) || *p == '_' || *p == '$' || *p == '#') && n < MOCK_NAME_LEN - 1; ++p)
+        name[n++] = toupper ((unsigned char) *p);
+    }
+    name[n] = '\0';
+    /* skip the schema */
+    if (*p != '.')
+      break;
+    ++p;
+  }
+}
+
+/** mockParseType
+ *   Set type, size and codepage of a column from a DB2 type name.
+ *   Returns 0 for an unknown type.
+ */
+static int mockParseType (MockColumn* col, const char* type) {
+  char  name[32];
+  long  a   = -1;
+  long  b   = -1;
+  int   n   = 0;
+  const char* p = type;
+  char* end;
+
+  while (isalpha ((unsigned char) *p) && n < (int) sizeof (name) - 1)
+    name[n++] = toupper ((unsigned char) *p++);
+  name[n] = '\0';
+  while (*p == ' ')
+    ++p;
+  if (*p == '(') {
+    a = strtol (p + 1, &end, 10);
+    /* LOB lengths may carry a unit */
+    switch (toupper ((unsigned char) *end)) {
+      case 'K': a *= 1024L;               ++end; break;
+      case 'M': a *= 1024L * 1024L;        ++end; break;
+      case 'G': a *= 1024L * 1024L * 1024L; ++end; break;
+    }
+    if (*end == ',')
+      b = strtol (end + 1, &end, 10);
+  }
+  col->scale    = 0;
+  col->codepage = 0;
+  if (strcmp (name, "SMALLINT") == 0) {
+    col->sqltype = SQL_SMALLINT;       col->size = 5;  col->octets = 2;
+  } else if (strcmp (name, "INTEGER") == 0 || strcmp (name, "INT") == 0) {
+    col->sqltype = SQL_INTEGER;        col->size = 10; col->octets = 4;
+  } else if (strcmp (name, "BIGINT") == 0) {
+    col->sqltype = SQL_BIGINT;         col->size = 19; col->octets = 8;
+  } else if (strcmp (name, "DECIMAL") == 0 || strcmp (name, "DEC") == 0 || strcmp (name, "NUMERIC") == 0) {
+    col->sqltype = SQL_DECIMAL;
+    col->size    = (a > 0) ? a : 5;
+    col->scale   = (b > 0) ? b : 0;
+    col->octets  = col->size + 2;
+  } else if (strcmp (name, "REAL") == 0) {
+    col->sqltype = SQL_REAL;           col->size = 7;  col->octets = 4;
+  } else if (strcmp (name, "DOUBLE") == 0 || strcmp (name, "FLOAT") == 0) {
+    col->sqltype = SQL_DOUBLE;         col->size = 15; col->octets = 8;
+  } else if (strcmp (name, "DECFLOAT") == 0) {
+    col->sqltype = SQL_DECFLOAT;       col->size = 34; col->octets = 16;
+  } else if (strcmp (name, "CHAR") == 0 || strcmp (name, "CHARACTER") == 0) {
+    col->sqltype = SQL_CHAR;           col->size = (a > 0) ? a : 1;       col->octets = col->size; col->codepage = 1208;
+  } else if (strcmp (name, "VARCHAR") == 0) {
+    col->sqltype = SQL_VARCHAR;        col->size = (a > 0) ? a : 1;       col->octets = col->size; col->codepage = 1208;
+  } else if (strcmp (name, "CLOB") == 0) {
+    col->sqltype = SQL_CLOB;           col->size = (a > 0) ? a : 1048576; col->octets = col->size; col->codepage = 1208;
+  } else if (strcmp (name, "BLOB") == 0) {
+    col->sqltype = SQL_BLOB;           col->size = (a > 0) ? a : 1048576; col->octets = col->size;
+  } else if (strcmp (name, "DATE") == 0) {
+    col->sqltype = SQL_TYPE_DATE;      col->size = 10; col->octets = 6;
+  } else if (strcmp (name, "TIME") == 0) {
+    col->sqltype = SQL_TYPE_TIME;      col->size = 8;  col->octets = 6;
+  } else if (strcmp (name, "TIMESTAMP") == 0) {
+    col->sqltype = SQL_TYPE_TIMESTAMP; col->size = 26; col->octets = 16; col->scale = 6;
+  } else if (strcmp (name, "BOOLEAN") == 0) {
+    col->sqltype = SQL_BOOLEAN;        col->size = 1;  col->octets = 1;
+  } else {
+    return 0;
+  }
+  return 1;
+}
+
+/** mockParseColumns
+ *   Set the columns of the table from a "NAME TYPE, ..." list.
+ *   Returns 0 if the list is invalid.
+ */
+static int mockParseColumns (MockHandle* h, const char* spec) {
+  const char* p = spec;
+  const char* item;
+  char        buf[256];
+  int         depth;
+  int         n;
+  size_t      len;
+
+  h->ncols = 0;
+  while (*p != '\0') {
+    /* find the end of the item, commas in parentheses do not count */
+    item  = p;
+    depth = 0;
+    while (*p != '\0' && !(*p == ',' && depth == 0)) {
+      if (*p == '(')
+        ++depth;
+      else if (*p == ')')
+        --depth;
+      ++p;
+    }
+    len = (size_t) (p - item);
+    if (*p == ',')
+      ++p;
+    if (len >= sizeof (buf) || h->ncols >= MOCK_MAX_COLS)
+      return 0;
+    memcpy (buf, item, len);
+    buf[len] = '\0';
+    item = buf;
+    while (*item == ' ' || *item == '\t' || *item == '\n')
+      ++item;
+    if (*item == '\0')
+      continue;
+    n = 0;
+    while (*item != '\0' && *item != ' ' && *item != '\t' && n < MOCK_NAME_LEN - 1)
+      h->cols[h->ncols].name[n++] = toupper ((unsigned char) *item++);
+    h->cols[h->ncols].name[n] = '\0';
+    while (*item == ' ' || *item == '\t')
+      ++item;
+    if (!mockParseType (&h->cols[h->ncols], item))
+      return 0;
+    ++h->ncols;
+  }
+  return h->ncols > 0;
+}
+
+/** mockParseResult
+ *   Map the columns of a SELECT list to table columns.
+ */
+static void mockParseResult (MockHandle* h, const char* list, const char* end) {
+  const char* p = list;
+  const char* item;
+  const char* stop;
+  const char* name;
+  char        ident[MOCK_NAME_LEN];
+  int         depth;
+  char        quote;
+  int         n;
+  int         i;
+
+  while (p < end && (*p == ' ' || *p == '\n'))
+    ++p;
+  if (*p == '*') {
+    for (i = 0; i < h->ncols; ++i)
+      h->result[i] = i;
+    h->nresult = h->ncols;
+    return;
+  }
+  h->nresult = 0;
+  while (p < end && h->nresult < MOCK_MAX_COLS) {
+    item  = p;
+    depth = 0;
+    quote = '\0';
+    while (p < end && !(*p == ',' && depth == 0 && quote == '\0')) {
+      if (quote != '\0') {
+        if (*p == quote)
+          quote = '\0';
+      } else if (*p == '"' || *p == '\'') {
+        quote = *p;
+      } else if (*p == '(') {
+        ++depth;
+      } else if (*p == ')') {
+        --depth;
+      }
+      ++p;
+    }
+    stop = p;
+    if (p < end)
+      ++p;
+    while (item < stop && (*item == ' ' || *item == '\n'))
+      ++item;
+    while (stop > item && (stop[-1] == ' ' || stop[-1] == '\n'))
+      --stop;
+    /* a plain column reference, possibly qualified: compare the last part */
+    name = item;
+    for (i = 0; item + i < stop; ++i) {
+      if (item[i] == '.')
+        name = item + i + 1;
+    }
+    n = 0;
+    if (*name == '"') {
+      for (++name; name < stop && *name != '"' && n < MOCK_NAME_LEN - 1; ++name)
+        ident[n++] = *name;
+      if (name < stop)
+        ++name;
+    } else {
+      for (; name < stop && (isalnum ((unsigned char) *name) || *name == '_') && n < MOCK_NAME_LEN - 1; ++name)
+        ident[n++] = toupper ((unsigned char) *name);
+    }
+    ident[n] = '\0';
+    h->result[h->nresult] = -1;
+    if (name == stop) {
+      for (i = 0; i < h->ncols; ++i) {
+        if (strcmp (h->cols[i].name, ident) == 0) {
+          h->result[h->nresult] = i;
+          break;
+        }
+      }
+    }
+    ++h->nresult;
+  }
+}
+
+/** mockParse
+ *   Find out what kind of statement this is, which table it refers to
+ *   and which columns it returns.
+ */
+static SQLRETURN mockParse (MockHandle* h, const char* text, SQLINTEGER len) {
+  char*       sql;
+  char        table[MOCK_NAME_LEN];
+  char        envname[MOCK_NAME_LEN + 32];
+  const char* spec;
+  const char* from;
+  const char* first;
+  const char* p;
+  long        limit;
+  char        quote = '\0';
+
+  if (len == SQL_NTS)
+    len = (SQLINTEGER) strlen (text);
+  if ((sql = malloc ((size_t) len + 1)) == NULL)
+    return mockDiag (h, "HY001", -99999, "Memory allocation failure.");
+  memcpy (sql, text, (size_t) len);
+  sql[len] = '\0';
+
+  h->prepared  = 0;
+  h->is_select = 0;
+  h->is_dml    = 0;
+  h->nresult   = 0;
+  h->ncols     = 0;
+  h->rows      = 0;
+  h->markers   = 0;
+  table[0]     = '\0';
+  for (p = sql; *p != '\0'; ++p) {
+    if (quote != '\0') {
+      if (*p == quote)
+        quote = '\0';
+    } else if (*p == '\'' || *p == '"') {
+      quote = *p;
+    } else if (*p == '?') {
+      ++h->markers;
+    }
+  }
+  for (p = sql; *p == ' ' || *p == '\t' || *p == '\n' || *p == '('; ++p)
+    ;
+  if (strncasecmp (p, "SELECT", 6) == 0 || strncasecmp (p, "WITH", 4) == 0) {
+    h->is_select = 1;
+    if ((from = mockKeyword (p, "FROM")) != NULL)
+      mockTableName (from + 4, table);
+  } else if (strncasecmp (p, "INSERT", 6) == 0) {
+    h->is_dml = 1;
+    if ((from = mockKeyword (p, "INTO")) != NULL)
+      mockTableName (from + 4, table);
+  } else if (strncasecmp (p, "UPDATE", 6) == 0) {
+    h->is_dml = 1;
+    mockTableName (p + 6, table);
+  } else if (strncasecmp (p, "DELETE", 6) == 0) {
+    h->is_dml = 1;
+    if ((from = mockKeyword (p, "FROM")) != NULL)
+      mockTableName (from + 4, table);
+  } else if (strncasecmp (p, "MERGE", 5) == 0) {
+    h->is_dml = 1;
+    if ((from = mockKeyword (p, "INTO")) != NULL)
+      mockTableName (from + 4, table);
+  }
+
+  if (h->is_select || h->is_dml) {
+    snprintf (envname, sizeof (envname), "MOCKCLI_COLUMNS_%s", table);
+    if ((spec = getenv (envname)) == NULL && (spec = getenv ("MOCKCLI_COLUMNS")) == NULL)
+      spec = mockDefaultColumns;
+    if (!mockParseColumns (h, spec)) {
+      free (sql);
+      return mockDiag (h, "42601", -104, "Invalid column list \"%s\" for table \"%s\".", spec, table);
+    }
+  }
+  if (h->is_select) {
+    snprintf (envname, sizeof (envname), "MOCKCLI_ROWS_%s", table);
+    h->rows = mockEnvLong (envname, mockDefaultRows);
+    if ((first = mockKeyword (p, "FIRST")) != NULL) {
+      limit = strtol (first + 5, NULL, 10);
+      if (limit >= 0 && limit < h->rows)
+        h->rows = limit;
+    }
+    from = mockKeyword (p, "FROM");
+    mockParseResult (h, p + 6, (from != NULL) ? from : p + strlen (p));
+  }
+  h->prepared = 1;
+  h->row      = -1;
+  free (sql);
+  return SQL_SUCCESS;
+}
+
+/** mockValue
+ *   The value of result column rcol in a row.
+ *   Returns its length, or SQL_NULL_DATA.  Strings and LOBs are cut from
+ *   the pattern (*pattern is set), other values are formatted into tmp.
+ */
+static SQLLEN mockValue (MockHandle* h, int rcol, long row, char* tmp, size_t tmpsize, int* pattern) {
+  int         col = h->result[rcol];
+  MockColumn* c;
+  long        ipart;
+  long        fpart;
+  long        mod;
+  int         i;
+
+  *pattern = 0;
+  if (col < 0) {
+    snprintf (tmp, tmpsize, "1");
+    return 1;
+  }
+  if (mockNullEvery > 0 && col > 0 && (row + col) % mockNullEvery == 0)
+    return SQL_NULL_DATA;
+  c = &h->cols[col];
+  switch (c->sqltype) {
+    case SQL_SMALLINT:
+      return snprintf (tmp, tmpsize, "%ld", row % 32767 + 1);
+    case SQL_INTEGER:
+      return snprintf (tmp, tmpsize, "%ld", row % 2147483647L + 1);
+    case SQL_BIGINT:
+      return snprintf (tmp, tmpsize, "%ld", row + 1);
+    case SQL_DECIMAL:
+      for (mod = 1, i = 0; i < (int) c->size - c->scale && i < 18; ++i)
+        mod *= 10;
+      ipart = (row + 1) % mod;
+      if (c->scale == 0)
+        return snprintf (tmp, tmpsize, "%ld", ipart);
+      for (mod = 1, i = 0; i < c->scale && i < 9; ++i)
+        mod *= 10;
+      fpart = (row * 37) % mod;
+      return snprintf (tmp, tmpsize, "%ld.%0*ld", ipart, (c->scale < 9) ? c->scale : 9, fpart);
+    case SQL_REAL:
+    case SQL_DOUBLE:
+    case SQL_DECFLOAT:
+      return snprintf (tmp, tmpsize, "%ld.25", row);
+    case SQL_CHAR:
+      *pattern = 1;
+      return (SQLLEN) c->size;
+    case SQL_VARCHAR:
+      *pattern = 1;
+      return (SQLLEN) (1 + (row * 7919) % (long) c->size);
+    case SQL_CLOB:
+    case SQL_BLOB:
+      *pattern = 1;
+      return (mockLobSize < (long) c->size) ? mockLobSize : (SQLLEN) c->size;
+    case SQL_TYPE_DATE:
+      return snprintf (tmp, tmpsize, "%04ld-%02ld-%02ld", 2000 + row % 25, row % 12 + 1, row % 28 + 1);
+    case SQL_TYPE_TIME:
+      return snprintf (tmp, tmpsize, "%02ld:%02ld:%02ld", row % 24, row % 60, (row / 60) % 60);
+    case SQL_TYPE_TIMESTAMP:
+      return snprintf (tmp, tmpsize, "%04ld-%02ld-%02ld %02ld:%02ld:%02ld.%06ld", 2000 + row % 25, row % 12 + 1, row % 28 + 1, row % 24, row % 60, (row / 60) % 60, row % 1000000);
+    case SQL_BOOLEAN:
+      return snprintf (tmp, tmpsize, "%d", (int) (row % 2));
+  }
+  snprintf (tmp, tmpsize, "1");
+  return 1;
+}
+
+/** mockCopy
+ *   Copy n bytes of a value from offset off.
+ */
+static void mockCopy (int pattern, const char* tmp, long row, SQLLEN off, char* dst, SQLLEN n) {
+  SQLLEN start;
+  SQLLEN chunk;
+
+  if (!pattern) {
+    memcpy (dst, tmp + off, (size_t) n);
+    return;
+  }
+  while (n > 0) {
+    start = (SQLLEN) ((row + off) % 26);
+    chunk = (n < MOCK_PATTERN_LEN) ? n : MOCK_PATTERN_LEN;
+    memcpy (dst, mockPattern + start, (size_t) chunk);
+    dst += chunk;
+    off += chunk;
+    n   -= chunk;
+  }
+}
+
+/** mockPut
+ *   Store the value of result column rcol of the current row in a bound buffer.
+ */
+static SQLRETURN mockPut (MockHandle* h, int rcol, MockBinding* b) {
+  char   tmp[96];
+  int    pattern = 0;
+  SQLLEN len     = mockValue (h, rcol, h->row, tmp, sizeof (tmp), &pattern);
+  SQLLEN n       = 0;
+
+  if (len == SQL_NULL_DATA) {
+    if (b->ind != NULL)
+      *b->ind = SQL_NULL_DATA;
+    return SQL_SUCCESS;
+  }
+  switch (b->ctype) {
+    case SQL_C_BLOB_LOCATOR:
+    case SQL_C_CLOB_LOCATOR:
+      /* the data are read with SQLGetData */
+      *(SQLINTEGER*) b->value = (SQLINTEGER) (h->row + 1);
+      if (b->ind != NULL)
+        *b->ind = sizeof (SQLINTEGER);
+      return SQL_SUCCESS;
+    case SQL_C_SBIGINT:
+      *(SQLBIGINT*) b->value = pattern ? 0 : strtoll (tmp, NULL, 10);
+      if (b->ind != NULL)
+        *b->ind = sizeof (SQLBIGINT);
+      return SQL_SUCCESS;
+    case SQL_C_LONG:
+      *(SQLINTEGER*) b->value = pattern ? 0 : (SQLINTEGER) strtol (tmp, NULL, 10);
+      if (b->ind != NULL)
+        *b->ind = sizeof (SQLINTEGER);
+      return SQL_SUCCESS;
+    case SQL_C_SHORT:
+      *(SQLSMALLINT*) b->value = pattern ? 0 : (SQLSMALLINT) strtol (tmp, NULL, 10);
+      if (b->ind != NULL)
+        *b->ind = sizeof (SQLSMALLINT);
+      return SQL_SUCCESS;
+    case SQL_C_DOUBLE:
+      *(SQLDOUBLE*) b->value = pattern ? 0 : strtod (tmp, NULL);
+      if (b->ind != NULL)
+        *b->ind = sizeof (SQLDOUBLE);
+      return SQL_SUCCESS;
+    case SQL_C_BINARY:
+      n = (len < b->buflen) ? len : b->buflen;
+      break;
+    default:
+      /* character data, terminated */
+      n = (len < b->buflen - 1) ? len : b->buflen - 1;
+      if (n < 0)
+        n = 0;
+      if (b->buflen > 0)
+        ((char*) b->value)[n] = '\0';
+      break;
+  }
+  mockCopy (pattern, tmp, h->row, 0, (char*) b->value, n);
+  if (b->ind != NULL)
+    *b->ind = len;
+  if (n < len) {
+    snprintf (h->sqlstate, sizeof (h->sqlstate), "01004");
+    snprintf (h->message, sizeof (h->message), "[IBM][CLI Driver] CLI0002W  Data truncated. SQLSTATE=01004");
+    h->native   = 0;
+    h->has_diag = 1;
+    return SQL_SUCCESS_WITH_INFO;
+  }
+  return SQL_SUCCESS;
+}
+
+/** mockReadParams
+ *   Read the bound parameters like a driver that sends them to the server.
+ */
+static void mockReadParams (MockHandle* h) {
+  MockBinding*   b;
+  unsigned long  sum = 0;
+  const unsigned char* p;
+  SQLLEN         len;
+  SQLLEN         i;
+  int            k;
+
+  for (k = 0; k < h->nparams && k < h->markers; ++k) {
+    b = &h->params[k];
+    if (b->value == NULL || (b->ind != NULL && (*b->ind == SQL_NULL_DATA || *b->ind == SQL_DATA_AT_EXEC || *b->ind <= SQL_LEN_DATA_AT_EXEC_OFFSET)))
+      continue;
+    switch (b->ctype) {
+      case SQL_C_SBIGINT: sum += (unsigned long) *(SQLBIGINT*) b->value;   break;
+      case SQL_C_DOUBLE:  sum += (unsigned long) *(SQLDOUBLE*) b->value;   break;
+      case SQL_C_LONG:    sum += (unsigned long) *(SQLINTEGER*) b->value;  break;
+      case SQL_C_SHORT:   sum += (unsigned long) *(SQLSMALLINT*) b->value; break;
+      default:
+        p   = (const unsigned char*) b->value;
+        len = (b->ctype == SQL_C_CHAR && (b->ind == NULL || *b->ind == SQL_NTS)) ? (SQLLEN) strlen ((const char*) p)
+            : (b->ctype == SQL_C_NUMERIC) ? (SQLLEN) sizeof (SQL_NUMERIC_STRUCT)
+            : (b->ind != NULL) ? *b->ind : b->buflen;
+        for (i = 0; i < len; ++i)
+          sum += p[i];
+        break;
+    }
+  }
+  h->checksum += sum;
+}
+
+/** mockExecuted
+ *   Finish an execution once all parameter data have arrived.
+ */
+static SQLRETURN mockExecuted (MockHandle* h) {
+  SQLRETURN rc = mockRoundTrip (h);
+
+  if (rc != SQL_SUCCESS)
+    return rc;
+  h->row         = -1;
+  h->getdata_col = 0;
+  h->rowcount    = h->is_dml ? 1 : (h->is_select ? -1 : 0);
+  return SQL_SUCCESS;
+}
+
+/** mockString
+ *   Return a string the way CLI does: truncated and terminated.
+ */
+static void mockString (const char* src, SQLCHAR* dst, SQLSMALLINT max, SQLSMALLINT* len) {
+  size_t n = strlen (src);
+
+  if (len != NULL)
+    *len = (SQLSMALLINT) n;
+  if (dst == NULL || max <= 0)
+    return;
+  if (n > (size_t) max - 1)
+    n = (size_t) max - 1;
+  memcpy (dst, src, n);
+  dst[n] = '\0';
+}
+
+/* ===== the CLI functions ===== */
+
+SQLRETURN SQL_API_FN SQLAllocHandle (SQLSMALLINT type, SQLHANDLE input, SQLHANDLE* output) {
+  MockHandle* h;
+
+  pthread_once (&mockOnce, mockInit);
+  if (output == NULL)
+    return SQL_ERROR;
+  if ((h = calloc (1, sizeof (MockHandle))) == NULL)
+    return SQL_ERROR;
+  h->kind = (type == SQL_HANDLE_ENV) ? MOCK_ENV : (type == SQL_HANDLE_DBC) ? MOCK_DBC : MOCK_STMT;
+  h->row  = -1;
+  *output = (SQLHANDLE) h;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLFreeHandle (SQLSMALLINT type, SQLHANDLE handle) {
+  if (handle == SQL_NULL_HANDLE)
+    return SQL_INVALID_HANDLE;
+  free (handle);
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLSetEnvAttr (SQLHENV henv, SQLINTEGER attr, SQLPOINTER value, SQLINTEGER len) {
+  return (henv == SQL_NULL_HANDLE) ? SQL_INVALID_HANDLE : SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLConnect (SQLHDBC hdbc, SQLCHAR* dsn, SQLSMALLINT dsnlen, SQLCHAR* uid, SQLSMALLINT uidlen, SQLCHAR* pwd, SQLSMALLINT pwdlen) {
+  if (hdbc == SQL_NULL_HANDLE)
+    return SQL_INVALID_HANDLE;
+  ((MockHandle*) hdbc)->has_diag = 0;
+  return mockRoundTrip ((MockHandle*) hdbc);
+}
+
+SQLRETURN SQL_API_FN SQLDriverConnect (SQLHDBC hdbc, SQLHWND hwnd, SQLCHAR* in, SQLSMALLINT inlen, SQLCHAR* out, SQLSMALLINT outmax, SQLSMALLINT* outlen, SQLUSMALLINT completion) {
+  if (hdbc == SQL_NULL_HANDLE)
+    return SQL_INVALID_HANDLE;
+  ((MockHandle*) hdbc)->has_diag = 0;
+  if (in != NULL)
+    mockString ((const char*) in, out, outmax, outlen);
+  return mockRoundTrip ((MockHandle*) hdbc);
+}
+
+SQLRETURN SQL_API_FN SQLDisconnect (SQLHDBC hdbc) {
+  return (hdbc == SQL_NULL_HANDLE) ? SQL_INVALID_HANDLE : SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLSetConnectAttr (SQLHDBC hdbc, SQLINTEGER attr, SQLPOINTER value, SQLINTEGER len) {
+  return (hdbc == SQL_NULL_HANDLE) ? SQL_INVALID_HANDLE : SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLGetConnectAttr (SQLHDBC hdbc, SQLINTEGER attr, SQLPOINTER value, SQLINTEGER max, SQLINTEGER* len) {
+  MockHandle* h  = (MockHandle*) hdbc;
+  SQLRETURN   rc = SQL_SUCCESS;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  switch (attr) {
+    case SQL_ATTR_CLIENT_CODEPAGE:
+      *(SQLINTEGER*) value = 1208;
+      break;
+    case SQL_ATTR_PING_DB:
+      /* the time of the round trip in microseconds */
+      rc = mockRoundTrip (h);
+      *(SQLINTEGER*) value = (SQLINTEGER) mockLatencyUs;
+      break;
+    default:
+      *(SQLINTEGER*) value = 0;
+      break;
+  }
+  if (len != NULL)
+    *len = sizeof (SQLINTEGER);
+  return rc;
+}
+
+SQLRETURN SQL_API_FN SQLGetInfo (SQLHDBC hdbc, SQLUSMALLINT type, SQLPOINTER value, SQLSMALLINT max, SQLSMALLINT* len) {
+  if (hdbc == SQL_NULL_HANDLE)
+    return SQL_INVALID_HANDLE;
+  switch (type) {
+    case SQL_DBMS_VER:
+    case SQL_DRIVER_VER:
+      mockString (MOCK_VERSION, (SQLCHAR*) value, max, len);
+      break;
+    case SQL_DBMS_NAME:
+      mockString ("DB2/LINUXX8664", (SQLCHAR*) value, max, len);
+      break;
+    default:
+      mockString ("", (SQLCHAR*) value, max, len);
+      break;
+  }
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLEndTran (SQLSMALLINT type, SQLHANDLE handle, SQLSMALLINT completion) {
+  if (handle == SQL_NULL_HANDLE)
+    return SQL_INVALID_HANDLE;
+  ((MockHandle*) handle)->has_diag = 0;
+  return mockRoundTrip ((MockHandle*) handle);
+}
+
+SQLRETURN SQL_API_FN SQLSetStmtAttr (SQLHSTMT hstmt, SQLINTEGER attr, SQLPOINTER value, SQLINTEGER len) {
+  MockHandle* h = (MockHandle*) hstmt;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  if (attr == SQL_ATTR_PREFETCH_NROWS)
+    h->block = (long) (intptr_t) value;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLPrepare (SQLHSTMT hstmt, SQLCHAR* sql, SQLINTEGER len) {
+  MockHandle* h  = (MockHandle*) hstmt;
+  SQLRETURN   rc;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  if ((rc = mockParse (h, (const char*) sql, len)) != SQL_SUCCESS)
+    return rc;
+  return mockRoundTrip (h);
+}
+
+SQLRETURN SQL_API_FN SQLExecute (SQLHSTMT hstmt) {
+  MockHandle* h = (MockHandle*) hstmt;
+  int         k;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  if (!h->prepared)
+    return mockDiag (h, "HY010", -99999, "Function sequence error.");
+  mockReadParams (h);
+  /* parameters bound with SQL_DATA_AT_EXEC are requested with SQLParamData */
+  for (k = 0; k < h->nparams && k < h->markers; ++k) {
+    MockBinding* b = &h->params[k];
+    if (b->value != NULL && b->ind != NULL && (*b->ind == SQL_DATA_AT_EXEC || *b->ind <= SQL_LEN_DATA_AT_EXEC_OFFSET)) {
+      h->need_data = 1;
+      h->dae_param = -1;
+      return SQL_NEED_DATA;
+    }
+  }
+  return mockExecuted (h);
+}
+
+SQLRETURN SQL_API_FN SQLExecDirect (SQLHSTMT hstmt, SQLCHAR* sql, SQLINTEGER len) {
+  MockHandle* h  = (MockHandle*) hstmt;
+  SQLRETURN   rc;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  if ((rc = mockParse (h, (const char*) sql, len)) != SQL_SUCCESS)
+    return rc;
+  return SQLExecute (hstmt);
+}
+
+SQLRETURN SQL_API_FN SQLParamData (SQLHSTMT hstmt, SQLPOINTER* token) {
+  MockHandle* h = (MockHandle*) hstmt;
+  int         k;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  if (!h->need_data)
+    return mockDiag (h, "HY010", -99999, "Function sequence error.");
+  for (k = h->dae_param + 1; k < h->nparams && k < h->markers; ++k) {
+    MockBinding* b = &h->params[k];
+    if (b->value != NULL && b->ind != NULL && (*b->ind == SQL_DATA_AT_EXEC || *b->ind <= SQL_LEN_DATA_AT_EXEC_OFFSET)) {
+      h->dae_param = k;
+      if (token != NULL)
+        *token = b->value;
+      return SQL_NEED_DATA;
+    }
+  }
+  h->need_data = 0;
+  return mockExecuted (h);
+}
+
+SQLRETURN SQL_API_FN SQLPutData (SQLHSTMT hstmt, SQLPOINTER data, SQLLEN len) {
+  MockHandle*          h   = (MockHandle*) hstmt;
+  const unsigned char* p   = (const unsigned char*) data;
+  unsigned long        sum = 0;
+  SQLLEN               i;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  if (!h->need_data || h->dae_param < 0)
+    return mockDiag (h, "HY010", -99999, "Function sequence error.");
+  if (len == SQL_NTS)
+    len = (SQLLEN) strlen ((const char*) data);
+  for (i = 0; i < len; ++i)
+    sum += p[i];
+  h->checksum += sum;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLBindParameter (SQLHSTMT hstmt, SQLUSMALLINT ipar, SQLSMALLINT iotype, SQLSMALLINT ctype, SQLSMALLINT sqltype, SQLULEN colsize, SQLSMALLINT scale, SQLPOINTER value, SQLLEN buflen, SQLLEN* ind) {
+  MockHandle* h = (MockHandle*) hstmt;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  if (ipar < 1 || ipar > MOCK_MAX_PARAMS)
+    return mockDiag (h, "07009", -99999, "Invalid descriptor index.");
+  h->params[ipar - 1].ctype  = ctype;
+  h->params[ipar - 1].value  = value;
+  h->params[ipar - 1].buflen = buflen;
+  h->params[ipar - 1].ind    = ind;
+  if (ipar > h->nparams)
+    h->nparams = ipar;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLBindCol (SQLHSTMT hstmt, SQLUSMALLINT icol, SQLSMALLINT ctype, SQLPOINTER value, SQLLEN buflen, SQLLEN* ind) {
+  MockHandle* h = (MockHandle*) hstmt;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  if (icol < 1 || icol > MOCK_MAX_COLS)
+    return mockDiag (h, "07009", -99999, "Invalid descriptor index.");
+  h->bound[icol - 1].ctype  = ctype;
+  h->bound[icol - 1].value  = value;
+  h->bound[icol - 1].buflen = buflen;
+  h->bound[icol - 1].ind    = ind;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLNumResultCols (SQLHSTMT hstmt, SQLSMALLINT* ncols) {
+  MockHandle* h = (MockHandle*) hstmt;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  *ncols = (SQLSMALLINT) (h->is_select ? h->nresult : 0);
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLDescribeCol (SQLHSTMT hstmt, SQLUSMALLINT icol, SQLCHAR* name, SQLSMALLINT namemax, SQLSMALLINT* namelen, SQLSMALLINT* sqltype, SQLULEN* colsize, SQLSMALLINT* scale, SQLSMALLINT* nullable) {
+  MockHandle* h = (MockHandle*) hstmt;
+  MockColumn* c;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  if (icol < 1 || icol > h->nresult)
+    return mockDiag (h, "07009", -99999, "Invalid descriptor index.");
+  if (h->result[icol - 1] < 0) {
+    mockString ("EXPR", name, namemax, namelen);
+    if (sqltype  != NULL) *sqltype  = SQL_VARCHAR;
+    if (colsize  != NULL) *colsize  = 32;
+    if (scale    != NULL) *scale    = 0;
+    if (nullable != NULL) *nullable = SQL_NULLABLE;
+    return SQL_SUCCESS;
+  }
+  c = &h->cols[h->result[icol - 1]];
+  mockString (c->name, name, namemax, namelen);
+  if (sqltype  != NULL) *sqltype  = c->sqltype;
+  if (colsize  != NULL) *colsize  = c->size;
+  if (scale    != NULL) *scale    = c->scale;
+  if (nullable != NULL) *nullable = (h->result[icol - 1] == 0) ? SQL_NO_NULLS : SQL_NULLABLE;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLColAttribute (SQLHSTMT hstmt, SQLUSMALLINT icol, SQLUSMALLINT field, SQLPOINTER chars, SQLSMALLINT charmax, SQLSMALLINT* charlen, SQLPOINTER number) {
+  MockHandle* h = (MockHandle*) hstmt;
+  MockColumn  expr;
+  MockColumn* c;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  if (icol < 1 || icol > h->nresult)
+    return mockDiag (h, "07009", -99999, "Invalid descriptor index.");
+  if (h->result[icol - 1] < 0) {
+    memset (&expr, 0, sizeof (expr));
+    snprintf (expr.name, sizeof (expr.name), "EXPR");
+    expr.sqltype  = SQL_VARCHAR;
+    expr.size     = 32;
+    expr.octets   = 32;
+    expr.codepage = 1208;
+    c = &expr;
+  } else {
+    c = &h->cols[h->result[icol - 1]];
+  }
+  switch (field) {
+    case SQL_DESC_NAME:
+      mockString (c->name, (SQLCHAR*) chars, charmax, charlen);
+      break;
+    case SQL_DESC_CODEPAGE:
+      *(SQLINTEGER*) number = c->codepage;
+      break;
+    case SQL_DESC_TYPE:
+      *(SQLLEN*) number = c->sqltype;
+      break;
+    case SQL_DESC_SCALE:
+      *(SQLLEN*) number = c->scale;
+      break;
+    case SQL_DESC_OCTET_LENGTH:
+      *(SQLLEN*) number = c->octets;
+      break;
+    case SQL_DESC_PRECISION:
+    case SQL_DESC_LENGTH:
+    default:
+      *(SQLLEN*) number = (SQLLEN) c->size;
+      break;
+  }
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLGetCursorName (SQLHSTMT hstmt, SQLCHAR* name, SQLSMALLINT max, SQLSMALLINT* len) {
+  char cursor[32];
+
+  if (hstmt == SQL_NULL_HANDLE)
+    return SQL_INVALID_HANDLE;
+  snprintf (cursor, sizeof (cursor), "SQLCUR%lu", __sync_add_and_fetch (&mockCursors, 1));
+  mockString (cursor, name, max, len);
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLFetchScroll (SQLHSTMT hstmt, SQLSMALLINT orientation, SQLLEN offset) {
+  MockHandle* h      = (MockHandle*) hstmt;
+  SQLRETURN   result = SQL_SUCCESS;
+  SQLRETURN   rc;
+  long        block;
+  int         i;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  if (!h->is_select || h->row < -1)
+    return mockDiag (h, "24000", -99999, "Invalid cursor state.");
+  if (h->row + 1 >= h->rows) {
+    h->row = h->rows;
+    return SQL_NO_DATA;
+  }
+  ++h->row;
+  /* a new block of rows comes from the server */
+  block = (h->block > 0) ? h->block : mockBlockRows;
+  if (h->row % block == 0 && (rc = mockRoundTrip (h)) != SQL_SUCCESS)
+    return rc;
+  h->getdata_col = 0;
+  for (i = 0; i < h->nresult; ++i) {
+    if (h->bound[i].value != NULL && mockPut (h, i, &h->bound[i]) == SQL_SUCCESS_WITH_INFO)
+      result = SQL_SUCCESS_WITH_INFO;
+  }
+  return result;
+}
+
+SQLRETURN SQL_API_FN SQLFetch (SQLHSTMT hstmt) {
+  return SQLFetchScroll (hstmt, SQL_FETCH_NEXT, 0);
+}
+
+SQLRETURN SQL_API_FN SQLGetData (SQLHSTMT hstmt, SQLUSMALLINT icol, SQLSMALLINT ctype, SQLPOINTER value, SQLLEN buflen, SQLLEN* ind) {
+  MockHandle* h       = (MockHandle*) hstmt;
+  char        tmp[96];
+  int         pattern = 0;
+  SQLLEN      len;
+  SQLLEN      left;
+  SQLLEN      room;
+  SQLLEN      n;
+  SQLRETURN   rc;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  h->has_diag = 0;
+  if (!h->is_select || h->row < 0 || h->row >= h->rows)
+    return mockDiag (h, "24000", -99999, "Invalid cursor state.");
+  if (icol < 1 || icol > h->nresult)
+    return mockDiag (h, "07009", -99999, "Invalid descriptor index.");
+  if (icol != h->getdata_col) {
+    h->getdata_col = icol;
+    h->getdata_off = 0;
+  }
+  /* every call is a round trip, as for a LOB locator */
+  if ((rc = mockRoundTrip (h)) != SQL_SUCCESS)
+    return rc;
+  len = mockValue (h, icol - 1, h->row, tmp, sizeof (tmp), &pattern);
+  if (len == SQL_NULL_DATA) {
+    if (ind != NULL)
+      *ind = SQL_NULL_DATA;
+    return SQL_SUCCESS;
+  }
+  left = len - h->getdata_off;
+  if (h->getdata_off > 0 && left <= 0)
+    return SQL_NO_DATA;
+  room = (ctype == SQL_C_BINARY) ? buflen : buflen - 1;
+  if (room < 0)
+    room = 0;
+  n = (left < room) ? left : room;
+  if (value != NULL && buflen > 0) {
+    mockCopy (pattern, tmp, h->row, h->getdata_off, (char*) value, n);
+    if (ctype != SQL_C_BINARY)
+      ((char*) value)[n] = '\0';
+  } else {
+    n = 0;
+  }
+  if (ind != NULL)
+    *ind = left;
+  h->getdata_off += n;
+  if (n < left) {
+    snprintf (h->sqlstate, sizeof (h->sqlstate), "01004");
+    snprintf (h->message, sizeof (h->message), "[IBM][CLI Driver] CLI0002W  Data truncated. SQLSTATE=01004");
+    h->native   = 0;
+    h->has_diag = 1;
+    return SQL_SUCCESS_WITH_INFO;
+  }
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLRowCount (SQLHSTMT hstmt, SQLLEN* rowcount) {
+  MockHandle* h = (MockHandle*) hstmt;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  *rowcount = h->rowcount;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLFreeStmt (SQLHSTMT hstmt, SQLUSMALLINT option) {
+  MockHandle* h = (MockHandle*) hstmt;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  switch (option) {
+    case SQL_CLOSE:
+      h->row = h->rows;
+      break;
+    case SQL_UNBIND:
+      memset (h->bound, 0, sizeof (h->bound));
+      break;
+    case SQL_RESET_PARAMS:
+      memset (h->params, 0, sizeof (h->params));
+      h->nparams = 0;
+      break;
+    case SQL_DROP:
+      free (h);
+      break;
+  }
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLCancel (SQLHSTMT hstmt) {
+  MockHandle* h = (MockHandle*) hstmt;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  /* only a round trip in progress is interrupted */
+  if (h->busy)
+    h->cancel = 1;
+  h->need_data = 0;
+  return SQL_SUCCESS;
+}
+
+SQLRETURN SQL_API_FN SQLGetDiagRec (SQLSMALLINT type, SQLHANDLE handle, SQLSMALLINT rec, SQLCHAR* sqlstate, SQLINTEGER* native, SQLCHAR* message, SQLSMALLINT max, SQLSMALLINT* len) {
+  MockHandle* h = (MockHandle*) handle;
+
+  if (h == NULL)
+    return SQL_INVALID_HANDLE;
+  if (rec != 1 || !h->has_diag)
+    return SQL_NO_DATA;
+  if (sqlstate != NULL)
+    memcpy (sqlstate, h->sqlstate, 6);
+  if (native != NULL)
+    *native = h->native;
+  mockString (h->message, message, max, len);
+  return SQL_SUCCESS;
+}
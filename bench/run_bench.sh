@@ -0,0 +1,182 @@
+#!/bin/bash
+#
+# Throughput benchmarks for db2_fdw against the mock DB2 CLI library.
+#
+# Starts a temporary PostgreSQL cluster whose server loads lib/libdb2.so.1
+# instead of the DB2 client, creates a foreign table on the synthetic
+# table BENCH and measures scans, inserts, updates, deletes and planning.
+# db2_fdw must be installed in the PostgreSQL of PG_CONFIG.
+#
+# Settings (environment):
+#   BENCH_ROWS        rows per scan, update and delete, rows per insert   (100000)
+#   BENCH_RUNS        runs per test, the fastest one is reported            (3)
+#   BENCH_PLANS       statements planned for the planning latency           (200)
+#   BENCH_PORT        port of the temporary cluster                         (54329)
+#   BENCH_SETTINGS    SQL run before each test, e.g.
+#                     "SET db2_fdw.fetch_thread = on;"
+#   BENCH_TESTS       tests to run                    (scan insert update delete plan)
+#   MOCKCLI_*         behaviour of the mock library, see mockcli.c
+#
+set -e
+
+here=$(cd "$(dirname "$0")" && pwd)
+PG_CONFIG=${PG_CONFIG:-pg_config}
+bindir=$("$PG_CONFIG" --bindir)
+rows=${BENCH_ROWS:-100000}
+runs=${BENCH_RUNS:-3}
+plans=${BENCH_PLANS:-200}
+port=${BENCH_PORT:-54329}
+settings=${BENCH_SETTINGS:-}
+tests=${BENCH_TESTS:-"scan insert update delete plan"}
+
+export MOCKCLI_ROWS=${MOCKCLI_ROWS:-$rows}
+export MOCKCLI_COLUMNS=${MOCKCLI_COLUMNS:-"ID INTEGER, AMOUNT DECIMAL(15,2), NAME VARCHAR(100), CREATED TIMESTAMP, NOTE CLOB(1M)"}
+export MOCKCLI_LOB_SIZE=${MOCKCLI_LOB_SIZE:-1024}
+export LD_LIBRARY_PATH="$here/lib${LD_LIBRARY_PATH:+:$LD_LIBRARY_PATH}"
+
+if [ ! -f "$here/lib/libdb2.so.1" ]; then
+  echo "run \"make\" in $here first" >&2
+  exit 1
+fi
+if [ ! -f "$("$PG_CONFIG" --pkglibdir)/db2_fdw.so" ]; then
+  echo "db2_fdw is not installed in $("$PG_CONFIG" --pkglibdir), run \"make install\" first" >&2
+  exit 1
+fi
+
+work=$(mktemp -d "${TMPDIR:-/tmp}/db2_fdw_bench.XXXXXX")
+# the cluster and its logs are kept when the benchmark fails
+cleanup () {
+  status=$?
+  "$bindir/pg_ctl" -D "$work/data" -m immediate stop >/dev/null 2>&1 || true
+  if [ "$status" -eq 0 ]; then
+    rm -rf "$work"
+  else
+    echo "keeping $work for inspection" >&2
+  fi
+}
+trap cleanup EXIT
+
+psql () {
+  "$bindir/psql" -X -q -h "$work" -p "$port" -U postgres -d postgres -v ON_ERROR_STOP=1 "$@"
+}
+
+# the columns of the foreign table, the expressions that fill them from "i"
+# and the column that the update sets, all derived from MOCKCLI_COLUMNS
+eval "$(echo "$MOCKCLI_COLUMNS" | awk -v lob="$MOCKCLI_LOB_SIZE" -v q="'" '
+  {
+    # split at commas outside of parentheses
+    n = 0; depth = 0; item = "";
+    for (i = 1; i <= length($0); ++i) {
+      c = substr($0, i, 1);
+      if (c == "(") depth++;
+      if (c == ")") depth--;
+      if (c == "," && depth == 0) { items[++n] = item; item = ""; } else item = item c;
+    }
+    items[++n] = item;
+    cols = ""; vals = ""; upd = "";
+    for (k = 1; k <= n; ++k) {
+      split(items[k], w, " ");
+      name = tolower(w[1]);
+      type = toupper(items[k]); sub(/^ *[^ ]+ +/, "", type);
+      base = type; sub(/\(.*/, "", base); sub(/ +$/, "", base);
+      args = ""; if (match(type, /\(.*\)/)) args = substr(type, RSTART, RLENGTH);
+      len = args; gsub(/[^0-9,]/, "", len); split(len, l, ",");
+      if      (base == "SMALLINT")                 { pg = "smallint";         v = "(i % 32000)::smallint"; }
+      else if (base == "INTEGER" || base == "INT") { pg = "integer";          v = "i"; }
+      else if (base == "BIGINT")                   { pg = "bigint";           v = "i::bigint"; }
+      else if (base ~ /^(DECIMAL|DEC|NUMERIC)$/)   { pg = "numeric" args;     v = "(i % 1000) / 4.0"; }
+      else if (base == "REAL")                     { pg = "real";             v = "i * 1.5"; }
+      else if (base == "DOUBLE" || base == "FLOAT"){ pg = "double precision"; v = "i * 1.5"; }
+      else if (base == "DECFLOAT")                 { pg = "numeric";          v = "i * 1.5"; }
+      else if (base ~ /^CHAR(ACTER)?$/)            { pg = "character" args;   v = "left(" q "name " q " || i, " (l[1] ? l[1] : 1) ")"; }
+      else if (base == "VARCHAR")                  { pg = "varchar" args;     v = "left(" q "name " q " || i, " l[1] ")"; }
+      else if (base == "CLOB")                     { pg = "text";             v = "repeat(" q "x" q ", " lob ")"; }
+      else if (base == "BLOB")                     { pg = "bytea";            v = "convert_to(repeat(" q "x" q ", " lob "), " q "UTF8" q ")"; }
+      else if (base == "DATE")                     { pg = "date";             v = "date " q "2024-01-01" q " + i % 1000"; }
+      else if (base == "TIME")                     { pg = "time";             v = "time " q "00:00" q " + i * interval " q "1 second" q ""; }
+      else if (base == "TIMESTAMP")                { pg = "timestamp";        v = "timestamp " q "2024-01-01" q " + i * interval " q "1 second" q ""; }
+      else if (base == "BOOLEAN")                  { pg = "boolean";          v = "i % 2 = 0"; }
+      else { print "echo \"unsupported type in MOCKCLI_COLUMNS: " type "\" >&2; exit 1"; exit; }
+      # the first column is the key
+      cols = cols (k > 1 ? ", " : "") name " " pg (k == 1 ? " OPTIONS (key " q "true" q ")" : "");
+      vals = vals (k > 1 ? ", " : "") v;
+      if (k == 2) upd = name;
+    }
+    if (upd == "") upd = tolower(w[1]);
+    print "table_columns=\"" cols "\"";
+    print "insert_values=\"" vals "\"";
+    print "update_column=\"" upd "\"";
+  }')"
+
+echo "initializing cluster in $work"
+"$bindir/initdb" -D "$work/data" -A trust -U postgres >"$work/initdb.log" 2>&1
+"$bindir/pg_ctl" -D "$work/data" -w -l "$work/server.log" \
+  -o "-p $port -k $work -c listen_addresses=''" start >/dev/null
+
+psql <<EOF
+CREATE EXTENSION db2_fdw;
+CREATE SERVER mock FOREIGN DATA WRAPPER db2_fdw OPTIONS (dbserver 'MOCK');
+CREATE USER MAPPING FOR CURRENT_USER SERVER mock OPTIONS (user 'bench', password 'bench');
+CREATE FOREIGN TABLE bench ($table_columns) SERVER mock OPTIONS (table 'BENCH');
+EOF
+
+# run one statement in a new session, after a statement that connects to
+# the mock server; prints "elapsed_ms cpu_s max_rss_kb" of the statement
+measure () {
+  out=$(psql 2>&1 <<EOF
+$settings
+SELECT 1 FROM bench LIMIT 1 \g /dev/null
+SET client_min_messages = log;
+SET log_executor_stats = on;
+\timing on
+$1 \g /dev/null
+EOF
+)
+  echo "$out" | awk '
+    /^Time: /                        { ms = $2 }
+    /s user, .* s system, /          { gsub(/!/, ""); cpu = $1 + $4 }
+    /kB max resident size/           { gsub(/!/, ""); rss = $1 }
+    /ERROR/                          { print "error: " $0 > "/dev/stderr"; failed = 1 }
+    END                              { if (failed || ms == "") exit 1; print ms, cpu, rss }'
+}
+
+# the fastest of $runs runs of a statement, printed as a result line
+report () {
+  best=""
+  for run in $(seq "$runs"); do
+    result=$(measure "$2") || { echo "$1: failed, see $work/server.log" >&2; exit 1; }
+    if [ -z "$best" ] || awk -v a="$result" -v b="$best" 'BEGIN { split(a, x, " "); split(b, y, " "); exit !(x[1] < y[1]) }'; then
+      best=$result
+    fi
+  done
+  echo "$best" | awk -v name="$1" -v rows="$rows" '{
+    printf "%-8s %10d %12.1f %12.0f %12.2f %12d\n", name, rows, $1, rows / ($1 / 1000.0), $2 * 1000000.0 / rows, $3 }'
+}
+
+echo
+echo "rows: $rows, columns: $MOCKCLI_COLUMNS, LOB size: $MOCKCLI_LOB_SIZE, latency: ${MOCKCLI_LATENCY_US:-0} us"
+[ -n "$settings" ] && echo "settings: $settings"
+printf "%-8s %10s %12s %12s %12s %12s\n" test rows "elapsed ms" "rows/s" "CPU us/row" "max RSS kB"
+for t in $tests; do
+  case $t in
+    scan)
+      report scan "SELECT count(*), sum(length(b::text)) FROM bench b" ;;
+    insert)
+      report insert "INSERT INTO bench SELECT $insert_values FROM generate_series(1, $rows) AS i" ;;
+    update)
+      report update "UPDATE bench SET $update_column = $update_column" ;;
+    delete)
+      report delete "DELETE FROM bench" ;;
+    plan)
+      # planning describes the remote table, the first one also connects
+      for i in $(seq "$plans"); do
+        echo "EXPLAIN (SUMMARY ON) SELECT * FROM bench WHERE $update_column IS NOT NULL;"
+      done | { echo "$settings"; cat; } | psql 2>&1 | awk '
+        /Planning Time:/ { if (count++ == 0) first = $3; else sum += $3 }
+        END {
+          if (count < 2) { print "plan: failed" > "/dev/stderr"; exit 1 }
+          printf "\nplanning: first %.3f ms, average of the next %d %.3f ms\n", first, count - 1, sum / (count - 1) }' ;;
+    *)
+      echo "unknown test: $t" >&2; exit 1 ;;
+  esac
+done
@@ -0,0 +1,32 @@
+#ifndef DB2ASYNCEXEC_H
+#define DB2ASYNCEXEC_H
+#include <pthread.h>
+/** DB2AsyncExec
+ *  Helper thread that executes a prepared DML statement, so that the backend
+ *  can produce the next row while DB2 applies the previous one.
+ *  At most one execution is pending: the backend waits for it and checks its
+ *  result before it binds the parameters of the next row, which therefore
+ *  stay untouched while DB2 reads them.
+ *  The thread only calls SQLExecute and SQLRowCount, the diagnostics of a
+ *  failed execution are collected by the backend.
+ *  All fields below "mutex" are protected by it.
+ *
+ *  @see    db2ExecuteAsync.c
+ *  @author Ing. Wolfgang Brandl
+ *  @since  18.2.0
+ */
+typedef struct db2AsyncExec {
+  SQLHSTMT            hsql;                   // statement handle the thread executes
+  SQLLEN*             indicators;             // indicators bound for the pending execution
+  pthread_t           thread;                 // helper thread
+  pthread_mutex_t     mutex;                  // protects the fields below
+  pthread_cond_t      cond;                   // signalled whenever "pending" changes
+  int                 pending;                // 1 = an execution was handed to the thread and is not checked yet
+  int                 done;                   // 1 = the pending execution has finished
+  int                 stop;                   // 1 = the backend closes the statement
+  unsigned long       iteration;              // number of the row within the modification
+  SQLRETURN           rc;                     // result of SQLExecute
+  SQLLEN              rowcount;               // rows processed, if SQLExecute succeeded
+  double              exec_ms;                // time SQLExecute took, in milliseconds
+} DB2AsyncExec;
+#endif
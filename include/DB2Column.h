@@ -20,6 +20,7 @@ typedef struct db2Column {
   int                 pgattnum;      // PG attribute number
   Oid                 pgtype;        // PG data type
   int                 pgtypmod;      // PG type modifier
+  Oid                 pginput;       // cached PG type input function, InvalidOid until first needed
   int                 used;          // is the column used in the query?
   int                 pkey;          // nonzero for primary keys, later set to the resjunk attribute number
   char*               val;           // buffer for DB2 to return results in (LOB locator for LOBs)
@@ -28,6 +29,8 @@ typedef struct db2Column {
   int                 val_null;      // indicator for NULL value
   int                 varno;         // range table index of this column's relation
   db2NoEncErrType     noencerr;      // no encoding error produced
+  int                 lobInline;     // 1 if a LOB is small enough to be bound with the row instead of using a locator
+  int                 convUtf8;      // 1 if DB2 converts the column from another codepage to UTF-8, so the data need no validation
 } DB2Column;
 
 #endif
\ No newline at end of file
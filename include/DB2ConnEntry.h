@@ -6,6 +6,10 @@
  *  a specific connection. Each connection is identifyable by servername, userid.
  *  It is not recommend to identify by password.
  * 
+ *  Each DB2EnvEntry additionally keeps its connections in a small hash table
+ *  ("connhash", chained through "hnext"), so that a connection is found without
+ *  walking the list and comparing strings.
+ * 
  *  Attached to a specific connection is a pure forward linked list of HdlEntry elemens
  *  in "handleList". By that the code is able to reuse any active statment handle in that
  *  chain.
@@ -22,7 +26,17 @@ typedef struct connEntry {
   SQLHDBC             hdbc;       // SQL DB connect handle
   ULONG               conAttr;    // connection attributes
   HdlEntry*           handlelist; // linked list of statement handles
-  int                 xact_level; // transaction level 0 = none, 1 = main, else subtransaction
+  int                 xact_level; // transaction level 0 = none, 1 = main, else highest subtransaction with a savepoint
+  int                 xact_dirty; // 1 = autocommit is off, the unit of work modified data or holds locks and must be ended
+  int                 read_locks; // 1 = the default isolation of the connection (RS, RR) keeps read locks until commit
+  unsigned int        hash;       // hash value of srvname and uid, selects the bucket in DB2EnvEntry.connhash
+  time_t              connected;  // time the connection was established
+  time_t              last_used;  // time the connection was last handed out or ended a transaction
+  unsigned long       uses;       // number of sessions that used the connection
+  unsigned long       commits;    // number of remote transactions committed
+  unsigned long       rollbacks;  // number of remote transactions rolled back
+  unsigned long       pings;      // number of liveness checks before reuse
+  struct connEntry*   hnext;      // next connection in the same hash bucket
   struct connEntry*   left;       // preceeding connection
   struct connEntry*   right;      // following connection
 } DB2ConnEntry;
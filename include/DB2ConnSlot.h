@@ -0,0 +1,36 @@
+#ifndef DB2CONNSLOT_H
+#define DB2CONNSLOT_H
+/** DB2ConnSlot
+ *  Number of DB2 connections all backends together hold to one DB2 database
+ *  and number of backends running remote queries on it, with admission statistics.
+ *  The slots live in shared memory and are only available if db2_fdw is loaded
+ *  via shared_preload_libraries; db2_fdw.max_connections is enforced against "used",
+ *  the server option max_concurrent_queries against "queries".
+ *  A slot is identified by the dbserver of the foreign server and assigned on first use;
+ *  once all slots were assigned, the slot of a database without connections and queries is reused.
+ *  All slots are protected by DB2ConnSlots.lock, the LWLock of the tranche
+ *  "db2_fdw connection slots"; backends waiting for a free
+ *  connection sleep on DB2ConnSlots.cv, those waiting to run a query on DB2ConnSlots.qcv.
+ *
+ *  @see    db2ConnSlots.c
+ *  @author Ing. Wolfgang Brandl
+ *  @since  18.2.0
+ */
+#define DB2_CONN_SLOT_NAME_LEN 256
+
+typedef struct db2ConnSlot {
+  char                dbserver[DB2_CONN_SLOT_NAME_LEN]; // DB2 database, empty if the slot is unused
+  int                 used;                             // open connections of all backends
+  int                 queries;                          // backends running remote queries
+  int64               admitted;                         // queries admitted so far
+  int64               queued;                           // queries that had to wait before admission
+  double              queue_ms;                         // total time queries waited, in milliseconds
+} DB2ConnSlot;
+
+typedef struct db2ConnSlots {
+  LWLock*             lock;                             // protects all slots
+  ConditionVariable   cv;                               // signalled whenever a connection is closed
+  ConditionVariable   qcv;                              // signalled whenever a backend finishes its queries
+  DB2ConnSlot         slot[DB2_CONN_SLOTS];             // one entry per DB2 database
+} DB2ConnSlots;
+#endif
@@ -0,0 +1,27 @@
+#ifndef DB2CONNSTAT_H
+#define DB2CONNSTAT_H
+#include <time.h>
+/** DB2ConnStat
+ *  Snapshot of one cached DB2 connection, shown by db2_fdw_connections.
+ *  The DB2 side copies the statistics of DB2ConnEntry into an array of these,
+ *  since the PostgreSQL side cannot see the connection cache itself.
+ *  The strings point into the cache and are only valid until the next connection
+ *  is opened or closed.
+ *
+ *  @see    db2ConnManager.c
+ *  @author Ing. Wolfgang Brandl
+ *  @since  18.2.0
+ */
+typedef struct db2ConnStat {
+  const char*         srvname;                // Server Name or IP Address
+  const char*         uid;                    // Userid
+  const char*         nls_lang;               // NLS_LANG of the environment
+  time_t              connected;              // time the connection was established
+  time_t              last_used;              // time the connection was last used
+  unsigned long       uses;                   // number of sessions that used the connection
+  unsigned long       commits;                // number of remote transactions committed
+  unsigned long       rollbacks;              // number of remote transactions rolled back
+  unsigned long       pings;                  // number of liveness checks before reuse
+  int                 in_xact;                // 1 = the connection takes part in the current transaction
+} DB2ConnStat;
+#endif
@@ -0,0 +1,23 @@
+#ifndef DB2DIAG_H
+#define DB2DIAG_H
+/** DB2Diag
+ *  Structured form of the diagnostic records of the last DB2 CLI call that failed.
+ *  It is only filled by db2CheckErr if a call did not succeed, so successful
+ *  calls do not pay for collecting any diagnostics.
+ *  The complete text of all records is kept in db2Message; db2Error_d names
+ *  the DB2 message of the first record in the hint of the error it raises.
+ *  Every db2CheckErr call resets "nrecs", so stale diagnostics are not reported.
+ *
+ *  @see    db2CheckErr.c
+ *  @author Ing. Wolfgang Brandl
+ *  @since  18.2.0
+ */
+typedef struct db2Diag {
+  int                 status;                 // return code of the failed call
+  char                sqlstate[SQLSTATE_LEN]; // SQLSTATE of the first diagnostic record
+  int                 sqlcode;                // native SQLCODE of the first diagnostic record
+  int                 nrecs;                  // number of diagnostic records
+  int                 line;                   // source line the failed call was checked in
+  const char*         file;                   // source file the failed call was checked in
+} DB2Diag;
+#endif
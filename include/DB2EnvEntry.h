@@ -17,6 +17,7 @@ typedef struct envEntry {
   char*               nls_lang;   // National Language Support language code
   SQLHENV             henv;       // SQL environment handle
   DB2ConnEntry*       connlist;   // double linked list of DB2ConnEntry elements
+  DB2ConnEntry*       connhash[DB2_CONN_HASH_SIZE]; // the same connections hashed by srvname and uid
   struct envEntry*    left;       // preceeding DB environment
   struct envEntry*    right;      // next DB environment
 } DB2EnvEntry;
@@ -31,10 +31,18 @@ typedef struct db2FdwState {
   Cost                total_cost;    // cost estimate, only needed for planning
   unsigned long       rowcount;      // rows already read from DB2
   int                 columnindex;   // currently processed column for error context
-  MemoryContext       temp_cxt;      // short-lived memory for data modification
+  MemoryContext       temp_cxt;      // short-lived memory for the current row, reset for each row
+  Size                peak_mem;      // largest amount of memory temp_cxt held for one row of a scan
+  DB2Metrics*         metrics;       // remote execution statistics, only collected for EXPLAIN ANALYZE
   unsigned long       prefetch;      // number of rows to prefetch
   char*               order_clause;  // for sort-pushdown
   char*               where_clause;  // deparsed where clause
+  char*               isolation;     // isolation clause for remote queries (UR, CS, RS, RR) or NULL
+  int                 query_timeout; // seconds after which DB2 cancels a statement, 0 for no limit
+  int                 max_queries;   // sessions that may run remote queries on the DB2 database at once, 0 for no limit
+  int                 admitted;      // 1 = the scan holds a query slot, see db2QuerySlotAcquire
+  char*               read_servers;  // comma separated DB2 databases for read-only scans or NULL
+  int                 read_policy;   // DB2_READ_ROUND_ROBIN or DB2_READ_LEAST_LOADED
   /*
    * Restriction clauses, divided into safe and unsafe to pushdown subsets.
    *
@@ -0,0 +1,30 @@
+#ifndef DB2METRICS_H
+#define DB2METRICS_H
+/** DB2Metrics
+ *  Remote execution statistics of one foreign scan or modify node, shown by EXPLAIN ANALYZE
+ *  and added to db2_fdw_stat_statements.
+ *  The structure is only allocated if the node is instrumented or statements are tracked,
+ *  the DB2 side finds it through DB2Session.metrics and does not take any timings otherwise.
+ *  Times are in milliseconds.
+ *
+ *  @see    db2Metrics.c
+ *  @author Ing. Wolfgang Brandl
+ *  @since  18.2.0
+ */
+typedef struct db2Metrics {
+  double              prepare_ms;             // time spent preparing the statement and binding the result columns
+  double              execute_ms;             // time spent in SQLExecute, including sending LOB parameters
+  double              fetch_ms;               // time spent in SQLFetchScroll
+  double              lob_ms;                 // time spent reading LOB values with SQLGetData
+  double              convert_ms;             // time spent converting result rows, without reading LOBs
+  double              queue_ms;               // time spent waiting for max_concurrent_queries
+  unsigned long       prepares;               // number of statements prepared
+  unsigned long       executions;             // number of SQLExecute calls
+  unsigned long       fetch_calls;            // number of SQLFetchScroll calls, or of waits for the fetch thread
+  unsigned long       rows;                   // number of rows fetched
+  unsigned long       bytes;                  // bytes of column data received, including LOBs
+  unsigned long       lob_bytes;              // bytes of LOB data received
+  unsigned long       queued;                 // number of times the query had to wait for max_concurrent_queries
+  int                 stored;                 // set once the figures were added to db2_fdw_stat_statements
+} DB2Metrics;
+#endif
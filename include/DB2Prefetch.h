@@ -0,0 +1,51 @@
+#ifndef DB2PREFETCH_H
+#define DB2PREFETCH_H
+#include <pthread.h>
+/** DB2Prefetch
+ *  Double buffer of a statement handle whose rows are fetched by a helper thread.
+ *  While the backend converts the rows of one block, the thread fetches the next
+ *  block from DB2 into the other one.  The result columns are bound to buffers
+ *  of the thread ("vals" and "inds"), so that fetching never overwrites the row
+ *  the backend converts.  A row is stored as the NULL indicator and the value of
+ *  each used column, in the order of DB2Table.cols, and is copied into the column
+ *  buffers of DB2Table when the backend takes it.
+ *  If "execute" is set, the thread opens the cursor with SQLExecute first, so
+ *  that the query runs on DB2 while the backend is still busy elsewhere.
+ *  The thread only calls DB2 CLI and copies memory, everything else,
+ *  including the diagnostics of a failed fetch, is done by the backend.
+ *  All fields below "mutex" are protected by it.
+ *
+ *  @see    db2Prefetch.c
+ *  @author Ing. Wolfgang Brandl
+ *  @since  18.2.0
+ */
+typedef struct db2PrefetchBlock {
+  char*               data;                   // packed rows
+  size_t              used;                   // bytes of "data" in use
+  int                 nrows;                  // rows in the block
+  SQLRETURN           rc;                     // result of the fetch that ended the block, SQL_SUCCESS if it is full
+  int                 ready;                  // 1 = filled by the thread, 0 = free for the thread
+} DB2PrefetchBlock;
+
+typedef struct db2Prefetch {
+  SQLHSTMT            hsql;                   // statement handle the thread fetches from
+  struct db2Table*    db2Table;               // bound columns, read by the thread
+  char**              vals;                   // buffers the columns are bound to, per column of db2Table
+  SQLLEN*             inds;                   // indicators the columns are bound to, per column of db2Table
+  size_t              rowmax;                 // largest possible size of a row image
+  size_t              blocksize;              // size of each block's data
+  int                 blockrows;              // maximum rows per block
+  int                 consume;                // block the backend reads from
+  int                 pos;                    // next row of that block
+  char*               next;                   // next row image in that block
+  int                 execute;                // 1 = the thread executes the statement before fetching
+  int                 exec_failed;            // 1 = SQLExecute failed, its result is in block[0].rc
+  double              exec_ms;                // time SQLExecute took in the thread, in milliseconds
+  pthread_t           thread;                 // helper thread
+  pthread_mutex_t     mutex;                  // protects the fields below
+  pthread_cond_t      cond;                   // signalled whenever a block changes state
+  int                 stop;                   // 1 = the backend closes the statement
+  int                 busy;                   // 1 = the thread is inside SQLExecute or SQLFetchScroll
+  DB2PrefetchBlock    block[2];               // the double buffer
+} DB2Prefetch;
+#endif
@@ -24,5 +24,6 @@ struct db2Session {
   DB2EnvEntry*        envp;
   DB2ConnEntry*       connp;
   HdlEntry*           stmtp;
+  DB2Metrics*         metrics;   // execution statistics for EXPLAIN ANALYZE, NULL if not collected
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef DB2STATENTRY_H
+#define DB2STATENTRY_H
+/** DB2StatEntry
+ *  Cumulative statistics of one remote statement in the db2_fdw_stat_statements hash table.
+ *  Entries live in shared memory and are keyed by database and the MD5 hash of the
+ *  statement text, which createQuery also puts into every SELECT as a comment.
+ *  The counters are protected by "mutex", the hash table itself by DB2StatShared.lock.
+ *  Times are in milliseconds.
+ *
+ *  @see    db2StatStatements.c
+ *  @author Ing. Wolfgang Brandl
+ *  @since  18.2.0
+ */
+#define DB2_STAT_QUERY_LEN 1024
+
+typedef struct db2StatKey {
+  Oid                 dbid;                          // database the statement was issued from
+  char                queryid[33];                   // MD5 hash of the statement text
+} DB2StatKey;
+
+typedef struct db2StatTime {
+  double              total;                         // sum over all calls
+  double              min;                           // shortest call
+  double              max;                           // longest call
+} DB2StatTime;
+
+typedef struct db2StatEntry {
+  DB2StatKey          key;                           // hash key, must be first
+  slock_t             mutex;                         // protects the counters
+  int64               calls;                         // number of foreign scans or modifications that ran the statement
+  int64               errors;                        // number of calls that ended with an error
+  int64               executions;                    // number of times the statement was executed in DB2
+  int64               rows;                          // rows fetched
+  int64               bytes;                         // bytes of column data received
+  int64               lob_bytes;                     // bytes of LOB data received
+  DB2StatTime         prepare;                       // time spent preparing per call
+  DB2StatTime         execute;                       // time spent executing per call
+  DB2StatTime         fetch;                         // time spent fetching per call
+  char                query[DB2_STAT_QUERY_LEN];     // statement text, possibly truncated
+} DB2StatEntry;
+
+typedef struct db2StatShared {
+  LWLock*             lock;                          // protects the hash table
+} DB2StatShared;
+
+/** DB2StatCall
+ *  Local bookkeeping for a running call, so that a call that ends with an
+ *  error is still counted when the executor's memory is released.
+ */
+typedef struct db2StatCall {
+  MemoryContextCallback callback;                    // registered with the executor's memory context
+  const char*         query;                         // statement text
+  DB2Metrics*         metrics;                       // figures collected for the call
+} DB2StatCall;
+#endif
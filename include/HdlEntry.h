@@ -22,6 +22,9 @@ typedef struct handleEntry
   struct handleEntry* next;
   SQLCHAR             dummy_buffer[4];   // Buffer for COUNT(*) queries with no columns
   SQLLEN              dummy_null;        // Null indicator for dummy buffer
+  int                 for_update;        // 1 if the query locks the rows it fetches (SELECT ... FOR UPDATE)
+  DB2Prefetch*        prefetch;          // fetch thread of a query, NULL if rows are fetched by the backend
+  DB2AsyncExec*       async;             // execute thread of a DML statement, NULL if executed by the backend
 } HdlEntry;
 
 #endif
\ No newline at end of file
@@ -10,7 +10,15 @@
 typedef struct paramDesc {
   Oid                 type;      // PG data type
   db2BindType         bindType;  // which type to use for binding to DB2 statement
-  char*               value;     // value rendered for DB2
+  char*               value;     // value rendered for DB2 (the varlena itself for LOBs)
+  long                value_len; // length of a LOB value, which is sent with SQLPutData
+  db2NativeType       native;    // format of value if it points to buf, NATIVE_NONE for a string
+  Oid                 outfunc;   // cached type output function, InvalidOid until first needed
+  union {
+    long long         ival;      // integer values, bound as SQL_C_SBIGINT
+    double            dval;      // floating point values, bound as SQL_C_DOUBLE
+    char              raw[32];   // room for a SQL_NUMERIC_STRUCT
+  }                   buf;       // preallocated buffer for binary parameter values
   void*               node;      // the executable expression
   int                 colnum;    // corresponding column in DB2Table (-1 in SELECT queries unless output column)
   int                 txts;      // transaction timestamp
@@ -62,9 +62,24 @@
 */
 
 /* db2_fdw version */
-#define DB2_FDW_VERSION "18.1.1"
+#define DB2_FDW_VERSION "18.2.0"
 /* number of bytes to read per LOB chunk */
 #define LOB_CHUNK_SIZE    8192
+/* defaults for db2_fdw.lob_chunk_size and db2_fdw.lob_inline_size */
+#define DEFAULT_LOB_CHUNK_SIZE  65536
+#define DEFAULT_LOB_INLINE_SIZE 32768
+/* default for db2_fdw.stat_max, the number of statements tracked in db2_fdw_stat_statements */
+#define DEFAULT_STAT_MAX        1000
+/* default for db2_fdw.connection_check_interval in seconds */
+#define DEFAULT_CONN_CHECK_INTERVAL 30
+/* default for db2_fdw.connection_wait_timeout in milliseconds */
+#define DEFAULT_CONN_WAIT_TIMEOUT   60000
+/* number of DB2 databases for which db2_fdw.max_connections is enforced */
+#define DB2_CONN_SLOTS          64
+/* number of hash buckets for the cached connections of one environment */
+#define DB2_CONN_HASH_SIZE      64
+/* bytes per block buffered by a fetch thread, unless one row is larger */
+#define DB2_PREFETCH_BLOCK_SIZE 1048576
 #define ERRBUFSIZE        2000
 #define SUBMESSAGE_LEN    200
 #define EXPLAIN_LINE_SIZE 1000
@@ -75,7 +90,12 @@
 #define COLUMN_NAME_LEN   129
 #define SQLSTATE_LEN      6
 
+#include "DB2Metrics.h"
+#include "DB2ConnStat.h"
+
 #ifdef SQL_H_SQLCLI1
+#include "DB2Prefetch.h"
+#include "DB2AsyncExec.h"
 #include "HdlEntry.h"
 #include "DB2ConnEntry.h"
 #include "DB2EnvEntry.h"
@@ -97,6 +117,47 @@ typedef enum {
 
 #include "DB2Column.h"
 #include "DB2Table.h"
+#include "DB2Diag.h"
+
+/* LOB fetch tuning, set by db2_fdw.lob_chunk_size and db2_fdw.lob_inline_size */
+extern int  db2LobChunkSize;
+extern int  db2LobInlineSize;
+
+/* wait events reported while a backend waits for DB2, see db2WaitEvent.c */
+typedef enum {
+  DB2_WAIT_CONNECT,
+  DB2_WAIT_PREPARE,
+  DB2_WAIT_EXECUTE,
+  DB2_WAIT_FETCH,
+  DB2_WAIT_LOB_READ,
+  DB2_WAIT_COMMIT,
+  DB2_WAIT_PING,
+  DB2_WAIT_CONNECT_SLOT,
+  DB2_WAIT_QUERY_SLOT,
+  DB2_WAIT_EVENTS
+} db2WaitEvent;
+
+/* statement statistics, set by db2_fdw.stat_max and db2_fdw.track_statements */
+extern int  db2StatMax;
+extern bool db2TrackStatements;
+
+/* connection management, set by db2_fdw.connection_idle_timeout, db2_fdw.connection_check_interval, db2_fdw.max_connections and db2_fdw.connection_wait_timeout */
+extern int  db2ConnIdleTimeout;
+extern int  db2ConnCheckInterval;
+extern int  db2MaxConnections;
+extern int  db2ConnWaitTimeout;
+
+/* end remote transactions concurrently, set by db2_fdw.parallel_commit */
+extern bool db2ParallelCommit;
+
+/* fetch result rows in a helper thread, set by db2_fdw.fetch_thread */
+extern bool db2FetchThread;
+
+/* execute remote queries in db2BeginForeignScan, set by db2_fdw.eager_execute */
+extern bool db2EagerExecute;
+
+/* execute INSERTs in a helper thread, set by db2_fdw.async_dml */
+extern bool db2AsyncDml;
 
 /* types to store parameter descriprions */
 typedef enum {
@@ -107,6 +168,35 @@ typedef enum {
   BIND_OUTPUT
 } db2BindType;
 
+/* binary representation of a parameter value, see ParamDesc */
+typedef enum {
+  NATIVE_NONE,
+  NATIVE_INT64,
+  NATIVE_DOUBLE
+} db2NativeType;
+
+/** Tracing
+ *  db2Debug1 .. db2Debug5 emit a DEBUG1 .. DEBUG5 message, but only if the
+ *  level is enabled by db2_fdw.trace_level; otherwise neither the message
+ *  is formatted nor are its arguments evaluated.
+ *  Building with -DDB2_FDW_NO_TRACE removes all trace calls.
+ */
+extern int  db2TraceLevel;
+extern void db2Trace (int level, const char* message, ...) __attribute__ ((format (gnu_printf, 2, 0)));
+#ifdef DB2_FDW_NO_TRACE
+#define db2Debug1(...) ((void) 0)
+#define db2Debug2(...) ((void) 0)
+#define db2Debug3(...) ((void) 0)
+#define db2Debug4(...) ((void) 0)
+#define db2Debug5(...) ((void) 0)
+#else
+#define db2Debug1(...) do { if (db2TraceLevel >= 1) db2Trace (1, __VA_ARGS__); } while (0)
+#define db2Debug2(...) do { if (db2TraceLevel >= 2) db2Trace (2, __VA_ARGS__); } while (0)
+#define db2Debug3(...) do { if (db2TraceLevel >= 3) db2Trace (3, __VA_ARGS__); } while (0)
+#define db2Debug4(...) do { if (db2TraceLevel >= 4) db2Trace (4, __VA_ARGS__); } while (0)
+#define db2Debug5(...) do { if (db2TraceLevel >= 5) db2Trace (5, __VA_ARGS__); } while (0)
+#endif
+
 /* PostgreSQL error messages we need */
 typedef enum {
   FDW_ERROR,
@@ -139,6 +229,17 @@ typedef enum {
 #define OPT_PREFETCH          "prefetch"
 #define OPT_NO_ENCODING_ERROR "no_encoding_error"
 #define OPT_BATCH_SIZE        "batch_size"
+#define OPT_ISOLATION_LEVEL   "isolation_level"
+#define OPT_QUERY_TIMEOUT     "query_timeout"
+#define OPT_MAX_CONCURRENT_QUERIES "max_concurrent_queries"
+#define OPT_READ_SERVERS      "read_servers"
+#define OPT_READ_POLICY       "read_policy"
+
+/* how read-only scans choose one of the "read_servers" */
+#define DB2_READ_ROUND_ROBIN  0
+#define DB2_READ_LEAST_LOADED 1
+/* maximum number of endpoints in "read_servers" */
+#define DB2_READ_ENDPOINTS    16
 
 /* types for the DB2 table description */
 typedef enum {
@@ -11,7 +11,6 @@
 
 /** external prototypes */
 extern bool            optionIsTrue              (const char* value);
-extern void            db2Debug1                 (const char* message, ...);
 #if PG_VERSION_NUM < 140000
 extern char*           db2strdup                 (const char* source);
 #endif
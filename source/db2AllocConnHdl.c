@@ -1,5 +1,7 @@
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
 #include <sqlcli1.h>
 #include <postgres_ext.h>
 #include "db2_fdw.h"
@@ -8,19 +10,22 @@
 extern char      db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
 
 /** external prototypes */
-extern void      db2Debug1            (const char* message, ...);
-extern void      db2Debug2            (const char* message, ...);
-extern void      db2Debug3            (const char* message, ...);
 extern void      db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
-extern void      db2RegisterCallback  (void* arg);
+extern void      db2RegisterCallback  (void);
 extern SQLRETURN db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
 extern void      db2FreeEnvHdl        (DB2EnvEntry* envp, const char* nls_lang);
 extern char*     db2strdup            (const char* p);
+extern void      db2WaitStart         (db2WaitEvent event);
+extern void      db2WaitEnd           (void);
+extern int       db2ConnSlotAcquire   (const char* dbserver, int wait);
+extern void      db2ConnSlotRelease   (const char* dbserver);
+extern void      db2DropIdleConnections(const char* srvname);
 
 /** local prototypes */
 DB2ConnEntry*    db2AllocConnHdl      (DB2EnvEntry* envp,const char* srvname, char* user, char* password, char* jwt_token, const char* nls_lang);
-DB2ConnEntry*    findconnEntry        (DB2ConnEntry* start, const char* srvname, const char* user);
-DB2ConnEntry*    insertconnEntry      (DB2ConnEntry* start, const char* srvname, const char* uid, const char* pwd, const char* jwt_token, SQLHDBC hdbc);
+unsigned int     hashconnEntry        (const char* srvname, const char* user);
+DB2ConnEntry*    findconnEntry        (DB2EnvEntry* envp, const char* srvname, const char* user);
+DB2ConnEntry*    insertconnEntry      (DB2EnvEntry* envp, const char* srvname, const char* uid, const char* pwd, const char* jwt_token, SQLHDBC hdbc);
 
 /** db2AllocConnHdl
  *
@@ -43,7 +48,7 @@ DB2ConnEntry* db2AllocConnHdl(DB2EnvEntry* envp,const char* srvname, char* user,
     // envp->connlist = connp = insertconnEntry (envp->connlist, srvname, user, password, hdbc);
   } else {
     /* search user session for this server in cache */
-    connp = findconnEntry(envp->connlist, srvname, user);
+    connp = findconnEntry(envp, srvname, user);
     if (connp == NULL) {
       /* Declare all variables at beginning for C90 compatibility */
       char connStr[4096];
@@ -51,11 +56,18 @@ DB2ConnEntry* db2AllocConnHdl(DB2EnvEntry* envp,const char* srvname, char* user,
       SQLCHAR outConnStr[1024];
       SQLSMALLINT outConnStrLen;
 
+      /* respect db2_fdw.max_connections, giving up our own idle connections to the database first */
+      if (!db2ConnSlotAcquire (srvname, 0)) {
+        db2DropIdleConnections (srvname);
+        db2ConnSlotAcquire (srvname, 1);
+      }
+
       /* create connection handle */
       rc = SQLAllocHandle(SQL_HANDLE_DBC, envp->henv, &hdbc);
       db2Debug3("  alloc dbc handle - rc: %d, henv: %d, hdbc: %d",rc, envp->henv, hdbc);
       rc = db2CheckErr(rc, envp->henv, SQL_HANDLE_ENV, __LINE__, __FILE__);
       if (rc  != SQL_SUCCESS) {
+        db2ConnSlotRelease (srvname);
         db2Error_d (FDW_UNABLE_TO_ESTABLISH_CONNECTION, "error connecting to DB2: SQLAllochHandle failed to allocate hdbc handle", db2Message);
       }
 
@@ -75,29 +87,36 @@ DB2ConnEntry* db2AllocConnHdl(DB2EnvEntry* envp,const char* srvname, char* user,
                              srvname, jwt_token);
 
         if (connStrLen >= sizeof(connStr)) {
+          db2ConnSlotRelease (srvname);
           db2Error_d (FDW_UNABLE_TO_ESTABLISH_CONNECTION, "connection string too long", " connection to foreign DB2 server");
         }
 
         db2Debug1("  connecting with connection string (token hidden)");
 
         /* Use SQLDriverConnect instead of SQLConnect */
+        db2WaitStart (DB2_WAIT_CONNECT);
         rc = SQLDriverConnect(hdbc, NULL, (SQLCHAR*)connStr, SQL_NTS,
                              outConnStr, sizeof(outConnStr), &outConnStrLen,
                              SQL_DRIVER_NOPROMPT);
+        db2WaitEnd ();
 
         db2Debug1("  connect to database(%s) with JWT token - rc: %d, hdbc: %d", srvname, rc, hdbc);
         rc = db2CheckErr(rc, hdbc, SQL_HANDLE_DBC, __LINE__, __FILE__);
         if (rc != SQL_SUCCESS) {
+          db2ConnSlotRelease (srvname);
           db2Error_d (FDW_UNABLE_TO_ESTABLISH_CONNECTION, "cannot authenticate with JWT token", " connection connectstring: %s ,%s", srvname, db2Message);
           db2Error_d (FDW_UNABLE_TO_ESTABLISH_CONNECTION, "cannot authenticate", " connection to foreign DB2 server,%s", db2Message);
         }
       } else {
         /* Traditional user/password authentication */
         db2Debug1("  using user/password authentication");
+        db2WaitStart (DB2_WAIT_CONNECT);
         rc = SQLConnect(hdbc, (SQLCHAR*)srvname, SQL_NTS, (SQLCHAR*)user, SQL_NTS, (SQLCHAR*)password, SQL_NTS);
+        db2WaitEnd ();
         db2Debug1("  connect to database(%s) - rc: %d, hdbc: %d",srvname, rc, hdbc);
         rc = db2CheckErr(rc, hdbc, SQL_HANDLE_DBC, __LINE__, __FILE__);
         if (rc != SQL_SUCCESS) {
+          db2ConnSlotRelease (srvname);
           db2Error_d (FDW_UNABLE_TO_ESTABLISH_CONNECTION, "cannot authenticate"," connection User: %s ,%s"            , user    , db2Message);
           db2Error_d (FDW_UNABLE_TO_ESTABLISH_CONNECTION, "cannot authenticate"," connection password: %s ,%s"        , password, db2Message);
           db2Error_d (FDW_UNABLE_TO_ESTABLISH_CONNECTION, "cannot authenticate"," connection connectstring: %s ,%s"   , srvname , db2Message);
@@ -107,16 +126,25 @@ DB2ConnEntry* db2AllocConnHdl(DB2EnvEntry* envp,const char* srvname, char* user,
 
       if (rc == SQL_SUCCESS) {
         /* add session handle to cache */
-        envp->connlist = connp = insertconnEntry (envp->connlist, srvname, user, password, jwt_token, hdbc);
+        connp = insertconnEntry (envp, srvname, user, password, jwt_token, hdbc);
 
-        /* set Autocommit off */
-        rc = SQLSetConnectAttr(hdbc, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER);
+        /* set Autocommit on, db2Transactional switches it off for statements that must be committed */
+        rc = SQLSetConnectAttr(hdbc, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_ON, SQL_IS_UINTEGER);
         rc = db2CheckErr(rc, hdbc, SQL_HANDLE_DBC, __LINE__, __FILE__);
         if (rc != SQL_SUCCESS) {
-          db2Error_d (FDW_UNABLE_TO_ESTABLISH_CONNECTION, "failed to set autocommit=off"," connection to foreign DB2 server,%s", db2Message);
+          db2Error_d (FDW_UNABLE_TO_ESTABLISH_CONNECTION, "failed to set autocommit=on"," connection to foreign DB2 server,%s", db2Message);
+        }
+        /* queries without an isolation clause run with the default of the connection */
+        {
+          SQLINTEGER isolation = 0;
+          rc = SQLGetConnectAttr(hdbc, SQL_ATTR_TXN_ISOLATION, &isolation, SQL_IS_INTEGER, NULL);
+          /* if in doubt, assume that reads keep locks */
+          connp->read_locks = (rc != SQL_SUCCESS || isolation == SQL_TXN_REPEATABLE_READ || isolation == SQL_TXN_SERIALIZABLE);
+          db2Debug2("  default isolation: %d, read_locks: %d", (int) isolation, connp->read_locks);
+          rc = SQL_SUCCESS;
         }
-        /* register callback for PostgreSQL transaction events */
-        db2RegisterCallback (connp);
+        /* make sure the callback for PostgreSQL transaction events is registered */
+        db2RegisterCallback ();
       }
     }
   }
@@ -124,24 +152,51 @@ DB2ConnEntry* db2AllocConnHdl(DB2EnvEntry* envp,const char* srvname, char* user,
   return connp;
 }
 
+/** hashconnEntry
+ *   Hash value of a connection, computed over server name and user.
+ *   NULL and empty strings hash alike, as they are treated as equal.
+ */
+unsigned int hashconnEntry(const char* srvname, const char* user) {
+  unsigned int  hash = 2166136261u;
+  const char*   p    = NULL;
+
+  /* FNV-1a over both strings, separated by a zero byte */
+  for (p = srvname ? srvname : ""; *p != '\0'; ++p)
+    hash = (hash ^ (unsigned char) *p) * 16777619u;
+  hash = (hash ^ 0) * 16777619u;
+  for (p = user ? user : ""; *p != '\0'; ++p)
+    hash = (hash ^ (unsigned char) *p) * 16777619u;
+  return hash;
+}
+
 /** findconnEntry
- * 
+ *   Look up the connection for server and user in the hash table of "envp".
  */
-DB2ConnEntry* findconnEntry(DB2ConnEntry* start, const char* srvname, const char* user) {
+DB2ConnEntry* findconnEntry(DB2EnvEntry* envp, const char* srvname, const char* user) {
   DB2ConnEntry* step = NULL;
+  unsigned int  hash = hashconnEntry(srvname, user);
   db2Debug2("  > findconnEntry");
-  for (step = start; step != NULL; step = step->right){
+  for (step = envp->connhash[hash % DB2_CONN_HASH_SIZE]; step != NULL; step = step->hnext){
+    int srv_null_or_empty;
+    int srvname_null_or_empty;
+    int srv_match;
+    int uid_null_or_empty;
+    int user_null_or_empty;
+    int uid_match;
+
+    if (step->hash != hash)
+      continue;
     /* NULL-safe comparison for JWT auth where user may be NULL or empty */
     /* Treat NULL and empty string as equivalent */
-    int srv_null_or_empty = (!step->srvname || step->srvname[0] == '\0');
-    int srvname_null_or_empty = (!srvname || srvname[0] == '\0');
-    int srv_match = (srv_null_or_empty && srvname_null_or_empty) ||
-                    (!srv_null_or_empty && !srvname_null_or_empty && strcmp(step->srvname, srvname) == 0);
+    srv_null_or_empty     = (!step->srvname || step->srvname[0] == '\0');
+    srvname_null_or_empty = (!srvname || srvname[0] == '\0');
+    srv_match             = (srv_null_or_empty && srvname_null_or_empty) ||
+                            (!srv_null_or_empty && !srvname_null_or_empty && strcmp(step->srvname, srvname) == 0);
 
-    int uid_null_or_empty = (!step->uid || step->uid[0] == '\0');
-    int user_null_or_empty = (!user || user[0] == '\0');
-    int uid_match = (uid_null_or_empty && user_null_or_empty) ||
-                    (!uid_null_or_empty && !user_null_or_empty && strcmp(step->uid, user) == 0);
+    uid_null_or_empty     = (!step->uid || step->uid[0] == '\0');
+    user_null_or_empty    = (!user || user[0] == '\0');
+    uid_match             = (uid_null_or_empty && user_null_or_empty) ||
+                            (!uid_null_or_empty && !user_null_or_empty && strcmp(step->uid, user) == 0);
 
     if (srv_match && uid_match) {
       break;
@@ -152,22 +207,22 @@ DB2ConnEntry* findconnEntry(DB2ConnEntry* start, const char* srvname, const char
 }
 
 /** insertconnEntry
- *
+ *   Add a new connection in front of the connection list and hash table of "envp".
  */
-DB2ConnEntry* insertconnEntry(DB2ConnEntry* start, const char* srvname, const char* uid, const char* pwd, const char* jwt_token, SQLHDBC hdbc) {
-  DB2ConnEntry* step = NULL;
-  DB2ConnEntry* new  = NULL;
+DB2ConnEntry* insertconnEntry(DB2EnvEntry* envp, const char* srvname, const char* uid, const char* pwd, const char* jwt_token, SQLHDBC hdbc) {
+  DB2ConnEntry* new    = NULL;
+  unsigned int  bucket = 0;
 
   db2Debug2("  > insertconnEntry");
   new = malloc(sizeof(DB2ConnEntry));
-  if (start == NULL){ /* first entry in list */
-    new->right = new->left = NULL;
-  } else {
-    for (step = start; step->right != NULL; step = step->right){ }
-    step->right = new;
-    new->left = step;
-    new->right = NULL;
+  if (new == NULL) {
+    db2Error_d (FDW_OUT_OF_MEMORY, "error connecting to DB2:"," failed to allocate %d bytes of memory", sizeof (DB2ConnEntry));
   }
+  new->left  = NULL;
+  new->right = envp->connlist;
+  if (envp->connlist != NULL)
+    envp->connlist->left = new;
+  envp->connlist = new;
   // generate a deep copy using strdup, so these values survive together with DB2ConnEntry
   new->srvname    = (srvname   && srvname[0]   != '\0') ? strdup(srvname)   : NULL;
   new->uid        = (uid       && uid[0]       != '\0') ? strdup(uid)       : NULL;
@@ -176,6 +231,18 @@ DB2ConnEntry* insertconnEntry(DB2ConnEntry* start, const char* srvname, const ch
   new->handlelist = NULL;
   new->hdbc       = hdbc;
   new->xact_level = 0;
+  new->xact_dirty = 0;
+  new->read_locks = 0;
+  new->connected  = new->last_used = time(NULL);
+  new->uses       = 0;
+  new->commits    = 0;
+  new->rollbacks  = 0;
+  new->pings      = 0;
+  /* link into the hash bucket */
+  new->hash       = hashconnEntry(srvname, uid);
+  bucket          = new->hash % DB2_CONN_HASH_SIZE;
+  new->hnext      = envp->connhash[bucket];
+  envp->connhash[bucket] = new;
   db2Debug2("  < insertconnEntry - returns: %x",new);
   return new;
 }
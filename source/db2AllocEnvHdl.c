@@ -12,9 +12,6 @@ extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set b
 
 /** external prototypes */
 extern void      db2SetHandlers       (void);
-extern void      db2Debug1            (const char* message, ...);
-extern void      db2Debug2            (const char* message, ...);
-extern void      db2Debug3            (const char* message, ...);
 extern void      db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
 extern SQLRETURN db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
 extern char*     db2strdup            (const char* p);
@@ -156,6 +153,7 @@ DB2EnvEntry* insertenvEntry(DB2EnvEntry* start, const char* nlslang, SQLHENV hen
   new->nls_lang = strdup(nlslang);  // important to use strdup since env will survive multiple PG scopes, and so needs nls_lang
   new->henv     = henv;
   new->connlist = NULL;
+  memset (new->connhash, 0, sizeof (new->connhash));
   new->left     = NULL;
   new->right    = NULL;
 
@@ -15,10 +15,6 @@
 extern DB2EnvEntry* rootenvEntry;          /* Linked list of handles for cached DB2 connections.            */
 
 /** external prototypes */
-extern void      db2Debug1            (const char* message, ...);
-extern void      db2Debug2            (const char* message, ...);
-extern void      db2Debug3            (const char* message, ...);
-extern void      db2Debug5            (const char* message, ...);
 extern void      db2Error             (db2error sqlstate, const char* message);
 extern void      db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
 
@@ -51,6 +47,9 @@ HdlEntry* db2AllocStmtHdl (SQLSMALLINT type, DB2ConnEntry* connp, db2error error
     /* add handle to linked list */
     db2Debug3("  entry->hsql: %d",entry->hsql);
     entry->type         = type;
+    entry->prefetch     = NULL;
+    entry->async        = NULL;
+    entry->for_update   = 0;
     db2Debug3("  entry->type: %d",entry->type);
     entry->next         = connp->handlelist;
     db2Debug3("  adding connp->handlelist: %x to entry->next: %x",connp->handlelist, entry->next);
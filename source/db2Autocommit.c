@@ -0,0 +1,56 @@
+#include <sqlcli1.h>
+#include <postgres_ext.h>
+#include "db2_fdw.h"
+
+/** external variables */
+extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
+
+/** external prototypes */
+extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
+extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
+
+/** local prototypes */
+void                db2Transactional     (DB2ConnEntry* connp);
+void                db2Autocommit        (DB2ConnEntry* connp, int noerror);
+
+/** db2Transactional
+ *   Switch the connection from autocommit to a unit of work that is ended
+ *   together with the PostgreSQL transaction.
+ *   This is called before the first statement that modifies data or keeps
+ *   locks until commit; plain reads run in autocommit mode and hold no
+ *   locks once their cursor is closed.
+ */
+void db2Transactional (DB2ConnEntry* connp) {
+  SQLRETURN rc = 0;
+
+  db2Debug1("> db2Transactional");
+  if (!connp->xact_dirty) {
+    db2Debug2("  db2_fdw::db2Transactional: set autocommit off");
+    rc = SQLSetConnectAttr(connp->hdbc, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_OFF, SQL_IS_UINTEGER);
+    rc = db2CheckErr(rc, connp->hdbc, SQL_HANDLE_DBC, __LINE__, __FILE__);
+    if (rc != SQL_SUCCESS) {
+      db2Error_d (FDW_UNABLE_TO_CREATE_EXECUTION, "error starting remote transaction: SQLSetConnectAttr failed to set autocommit off", db2Message);
+    }
+    connp->xact_dirty = 1;
+  }
+  db2Debug1("< db2Transactional");
+}
+
+/** db2Autocommit
+ *   Switch the connection back to autocommit once its unit of work is ended.
+ *   If that fails, the connection stays marked as modified, so that the next
+ *   transaction ends its unit of work explicitly.
+ *   If "noerror" is true, don't throw errors.
+ */
+void db2Autocommit (DB2ConnEntry* connp, int noerror) {
+  SQLRETURN rc = 0;
+
+  db2Debug1("> db2Autocommit");
+  rc = SQLSetConnectAttr(connp->hdbc, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER)SQL_AUTOCOMMIT_ON, SQL_IS_UINTEGER);
+  rc = db2CheckErr(rc, connp->hdbc, SQL_HANDLE_DBC, __LINE__, __FILE__);
+  connp->xact_dirty = (rc != SQL_SUCCESS);
+  if (rc != SQL_SUCCESS && !noerror) {
+    db2Error_d (FDW_UNABLE_TO_CREATE_EXECUTION, "error ending remote transaction: SQLSetConnectAttr failed to set autocommit on", db2Message);
+  }
+  db2Debug1("< db2Autocommit");
+}
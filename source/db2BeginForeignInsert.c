@@ -13,8 +13,6 @@
 extern DB2FdwState* db2GetFdwState             (Oid foreigntableid, double* sample_percent, bool describe);
 extern void         addParam                   (ParamDesc** paramList, Oid pgtype, short colType, int colnum, int txts);
 extern void         checkDataType              (short db2type, int scale, Oid pgtype, const char* tablename, const char* colname);
-extern void         db2Debug1                  (const char* message, ...);
-extern void         db2Debug2                  (const char* message, ...);
 extern void         appendAsType               (StringInfoData* dest, Oid type);
 extern void         db2BeginForeignModifyCommon(ModifyTableState* mtstate, ResultRelInfo* rinfo, DB2FdwState* fdw_state, Plan* subplan);
 
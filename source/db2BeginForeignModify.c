@@ -13,8 +13,6 @@
 
 /** external prototypes */
 extern void         db2PrepareQuery            (DB2Session* session, const char* query, DB2Table* db2Table, unsigned long prefetch);
-extern void         db2Debug1                  (const char* message, ...);
-extern void         db2Debug2                  (const char* message, ...);
 extern void*        db2alloc                   (const char* type, size_t size);
 extern char*        c2name                     (short fcType);
 extern void         db2BeginForeignModifyCommon(ModifyTableState* mtstate, ResultRelInfo* rinfo, DB2FdwState* fdw_state, Plan* subplan);
@@ -97,6 +95,22 @@ DB2FdwState* deserializePlanData (List* list) {
   state->prefetch = (unsigned long) DatumGetInt32 (((Const *) lfirst (cell))->constvalue);
   cell = list_next (list,cell);
 
+  /* DB2 query timeout */
+  state->query_timeout = (int) DatumGetInt32 (((Const *) lfirst (cell))->constvalue);
+  cell = list_next (list,cell);
+
+  /* concurrent remote queries */
+  state->max_queries = (int) DatumGetInt32 (((Const *) lfirst (cell))->constvalue);
+  cell = list_next (list,cell);
+
+  /* read endpoints */
+  state->read_servers = deserializeString (lfirst (cell));
+  cell = list_next (list,cell);
+
+  /* read routing policy */
+  state->read_policy = (int) DatumGetInt32 (((Const *) lfirst (cell))->constvalue);
+  cell = list_next (list,cell);
+
   /* table data */
   state->db2Table = (DB2Table*) db2alloc ("state->db2Table", sizeof (struct db2Table));
   state->db2Table->name = deserializeString (lfirst (cell));
@@ -170,6 +184,12 @@ DB2FdwState* deserializePlanData (List* list) {
     state->db2Table->cols[i]->noencerr = deserializeLong (lfirst (cell));
     db2Debug2("  state->db2Table->cols[%d]->noencerr: %d",i,state->db2Table->cols[i]->noencerr);
     cell = list_next (list,cell);
+    state->db2Table->cols[i]->lobInline = (int) DatumGetInt32 (((Const*) lfirst (cell))->constvalue);
+    db2Debug2("  state->db2Table->cols[%d]->lobInline: %d",i,state->db2Table->cols[i]->lobInline);
+    cell = list_next (list,cell);
+    state->db2Table->cols[i]->convUtf8 = (int) DatumGetInt32 (((Const*) lfirst (cell))->constvalue);
+    db2Debug2("  state->db2Table->cols[%d]->convUtf8: %d",i,state->db2Table->cols[i]->convUtf8);
+    cell = list_next (list,cell);
     /* allocate memory for the result value only when the column is used in query */
     state->db2Table->cols[i]->val      = (state->db2Table->cols[i]->used == 1) ? (char*) db2alloc ("state->db2Table->cols[i]->val", state->db2Table->cols[i]->val_size + 1) : NULL;
     db2Debug2("  state->db2Table->cols[%d]->val: %x",i,state->db2Table->cols[i]->val);
@@ -14,10 +14,14 @@
 extern regproc* output_funcs;
 
 /** external prototypes */
-extern DB2Session*     db2GetSession             (const char* connectstring, char* user, char* password, char* jwt_token, const char* nls_lang, int curlevel);
+extern DB2Session*     db2GetSession             (const char* connectstring, char* user, char* password, char* jwt_token, const char* nls_lang);
 extern void            db2PrepareQuery           (DB2Session* session, const char* query, DB2Table* db2Table, unsigned long prefetch);
-extern void            db2Debug1                 (const char* message, ...);
 extern void*           db2alloc                  (const char* type, size_t size);
+extern void            db2SetMetrics             (DB2Session* session, DB2Metrics* metrics);
+extern bool            db2StatEnabled            (void);
+extern void            db2StatBegin              (const char* query, DB2Metrics* metrics);
+extern void            db2SetQueryTimeout        (DB2Session* session, int timeout);
+extern int             db2QueryTimeout           (int timeout);
 
 /** local prototypes */
 void db2BeginForeignModifyCommon(ModifyTableState* mtstate, ResultRelInfo* rinfo, DB2FdwState* fdw_state, Plan* subplan);
@@ -32,8 +36,16 @@ void db2BeginForeignModifyCommon(ModifyTableState* mtstate, ResultRelInfo* rinfo
   rinfo->ri_FdwState = fdw_state;
 
   /* connect to DB2 database */
-  fdw_state->session = db2GetSession(fdw_state->dbserver, fdw_state->user, fdw_state->password, fdw_state->jwt_token, fdw_state->nls_lang, GetCurrentTransactionNestLevel());
+  fdw_state->session = db2GetSession(fdw_state->dbserver, fdw_state->user, fdw_state->password, fdw_state->jwt_token, fdw_state->nls_lang);
+  /* only EXPLAIN ANALYZE and db2_fdw_stat_statements pay for timing the DB2 calls */
+  fdw_state->metrics = NULL;
+  if (mtstate->ps.instrument != NULL || db2StatEnabled()) {
+    fdw_state->metrics = (DB2Metrics*) db2alloc("metrics", sizeof(DB2Metrics));
+    db2SetMetrics(fdw_state->session, fdw_state->metrics);
+    db2StatBegin(fdw_state->query, fdw_state->metrics);
+  }
   db2PrepareQuery(fdw_state->session, fdw_state->query, fdw_state->db2Table,0);
+  db2SetQueryTimeout(fdw_state->session, db2QueryTimeout(fdw_state->query_timeout));
 
   /* get the type output functions for the parameters */
   output_funcs = (regproc*) db2alloc("output_funcs", fdw_state->db2Table->ncols * sizeof(regproc *));
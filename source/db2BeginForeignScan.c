@@ -4,19 +4,33 @@
 #include <nodes/pathnodes.h>
 #include <optimizer/optimizer.h>
 #include <access/heapam.h>
+#include <utils/memutils.h>
+#include <utils/portal.h>
 #include <access/xact.h>
 #include "db2_fdw.h"
 #include "DB2FdwState.h"
 
 /** external prototypes */
-extern DB2Session*  db2GetSession             (const char* connectstring, char* user, char* password, char* jwt_token, const char* nls_lang, int curlevel);
+extern DB2Session*  db2GetSession             (const char* connectstring, char* user, char* password, char* jwt_token, const char* nls_lang);
 extern void*        db2alloc                  (const char* type, size_t size);
 extern DB2FdwState* deserializePlanData       (List* list);
-extern void         db2Debug1                 (const char* message, ...);
-extern void         db2Debug2                 (const char* message, ...);
+extern void         db2SetMetrics             (DB2Session* session, DB2Metrics* metrics);
+extern bool         db2StatEnabled            (void);
+extern void         db2StatBegin              (const char* query, DB2Metrics* metrics);
+extern char*        db2ReadServer             (DB2FdwState* fdw_state, bool read_only);
+extern void         db2PrepareQuery           (DB2Session* session, const char* query, DB2Table* db2Table, unsigned long prefetch);
+extern void         db2SetQueryTimeout        (DB2Session* session, int timeout);
+extern int          db2QueryTimeout           (int timeout);
+extern void         db2QuerySlotAcquire       (const char* dbserver, int limit, DB2Metrics* metrics);
+extern void         db2PrefetchExecute        (DB2Session* session, DB2Table* db2Table, unsigned long prefetch);
+
+/** global variables */
+bool                db2EagerExecute = false;  /* set by db2_fdw.eager_execute */
 
 /** local prototypes */
 void db2BeginForeignScan(ForeignScanState* node, int eflags);
+bool db2ScanIsCertain   (ForeignScanState* node);
+bool db2PlanReads       (Plan* plan, Plan* scan);
 
 /** db2BeginForeignScan
  *   Recover ("deserialize") connection information, remote query,
@@ -95,16 +109,144 @@ void db2BeginForeignScan(ForeignScanState* node, int eflags) {
   else
     elog (DEBUG3, "  begin foreign join");
 
+  /* scans of a statement that modifies nothing may go to a read endpoint, which then also counts for admission */
+  fdw_state->dbserver = db2ReadServer (fdw_state
+                                      ,node->ss.ps.state->es_plannedstmt->commandType == CMD_SELECT
+                                    && !node->ss.ps.state->es_plannedstmt->hasModifyingCTE
+                                      );
+
   /* connect to DB2 database */
   fdw_state->session = db2GetSession (fdw_state->dbserver
                                      ,fdw_state->user
                                      ,fdw_state->password
                                      ,fdw_state->jwt_token
                                      ,fdw_state->nls_lang
-                                     ,GetCurrentTransactionNestLevel()
     );
 
+  /* only EXPLAIN ANALYZE and db2_fdw_stat_statements pay for timing the DB2 calls */
+  fdw_state->metrics = NULL;
+  if (node->ss.ps.instrument != NULL || db2StatEnabled ()) {
+    fdw_state->metrics = (DB2Metrics*) db2alloc ("metrics", sizeof (DB2Metrics));
+    db2SetMetrics (fdw_state->session, fdw_state->metrics);
+    db2StatBegin (fdw_state->query, fdw_state->metrics);
+  }
+
+  /*
+   * Start the remote query right away, so that all queries of the plan run
+   * on DB2 at the same time; db2IterateForeignScan finds the statement open.
+   * Parameters only get their values during execution, so such scans wait,
+   * as do scans that might never be read and FOR UPDATE queries, which
+   * would lock rows early.
+   */
+  if (db2EagerExecute && fdw_state->paramList == NULL && !(eflags & EXEC_FLAG_EXPLAIN_ONLY)
+  &&  strstr (fdw_state->query, "FOR UPDATE") == NULL && db2ScanIsCertain (node)) {
+    db2Debug2("  execute query in foreign table scan eagerly");
+    db2PrepareQuery (fdw_state->session, fdw_state->query, fdw_state->db2Table, fdw_state->prefetch);
+    db2SetQueryTimeout (fdw_state->session, db2QueryTimeout (fdw_state->query_timeout));
+    if (fdw_state->max_queries > 0 && !fdw_state->admitted) {
+      db2QuerySlotAcquire (fdw_state->dbserver, fdw_state->max_queries, fdw_state->metrics);
+      fdw_state->admitted = 1;
+    }
+    db2PrefetchExecute (fdw_state->session, fdw_state->db2Table, fdw_state->prefetch);
+  }
+
   /* initialize row count to zero */
   fdw_state->rowcount = 0;
+  /* memory for converting a row, reset for each row */
+  fdw_state->temp_cxt = AllocSetContextCreate (node->ss.ps.state->es_query_cxt, "db2_fdw row data", ALLOCSET_DEFAULT_SIZES);
+  fdw_state->peak_mem = 0;
   db2Debug1("< db2BeginForeignScan");
 }
+
+/** db2ScanIsCertain
+ *   Return true if the executor is certain to read the scan at least once
+ *   when the statement runs: its portal is run to completion rather than
+ *   fetched from as a cursor, and the nodes above it do not skip it.
+ */
+bool db2ScanIsCertain (ForeignScanState* node) {
+  PlannedStmt* stmt = node->ss.ps.state->es_plannedstmt;
+
+  /* cursors, including those of PL/pgSQL loops, may never be fetched from */
+  if (ActivePortal == NULL || ActivePortal->name == NULL || ActivePortal->name[0] != '\0')
+    return false;
+  return (stmt != NULL && db2PlanReads (stmt->planTree, node->ss.ps.plan));
+}
+
+/** db2PlanReads
+ *   Return true if "scan" is read at least once whenever "plan" is.
+ *   LIMIT and joins, except for the side they start with, may end before
+ *   reaching a scan, and scans in subplans are not looked for.
+ */
+bool db2PlanReads (Plan* plan, Plan* scan) {
+  ListCell* cell;
+
+  if (plan == NULL)
+    return false;
+  if (plan == scan)
+    return true;
+  switch (nodeTag (plan)) {
+    case T_HashJoin:
+      /* mirrors ExecHashJoin: the side it starts with is read, the other one may be skipped */
+      switch (((Join*) plan)->jointype) {
+        case JOIN_FULL:
+          return (db2PlanReads (outerPlan (plan), scan) || db2PlanReads (innerPlan (plan), scan));
+        case JOIN_LEFT:
+        case JOIN_ANTI:
+          return db2PlanReads (outerPlan (plan), scan);
+        case JOIN_INNER:
+        case JOIN_SEMI:
+          if (outerPlan (plan)->startup_cost < innerPlan (plan)->total_cost)
+            return db2PlanReads (outerPlan (plan), scan);
+          return db2PlanReads (innerPlan (plan), scan);
+        default:
+          return db2PlanReads (innerPlan (plan), scan);
+      }
+    case T_NestLoop:
+    case T_MergeJoin:
+    case T_Hash:
+    case T_Agg:
+    case T_Sort:
+#if PG_VERSION_NUM >= 130000
+    case T_IncrementalSort:
+#endif
+    case T_Group:
+    case T_Unique:
+    case T_WindowAgg:
+    case T_Material:
+    case T_LockRows:
+    case T_ProjectSet:
+      return db2PlanReads (outerPlan (plan), scan);
+    case T_Result:
+      /* a constant qualification that is false skips the child */
+      return (((Result*) plan)->resconstantqual == NULL && db2PlanReads (outerPlan (plan), scan));
+    case T_SubqueryScan:
+      return db2PlanReads (((SubqueryScan*) plan)->subplan, scan);
+#if PG_VERSION_NUM >= 140000
+    case T_ModifyTable:
+      return db2PlanReads (outerPlan (plan), scan);
+#endif
+    case T_Append:
+      /* children are read one after the other, and partitions may be pruned at run time */
+#if PG_VERSION_NUM >= 180000
+      if (((Append*) plan)->part_prune_index >= 0 || ((Append*) plan)->appendplans == NIL)
+#else
+      if (((Append*) plan)->part_prune_info != NULL || ((Append*) plan)->appendplans == NIL)
+#endif
+        return false;
+      return db2PlanReads ((Plan*) linitial (((Append*) plan)->appendplans), scan);
+    case T_MergeAppend:
+#if PG_VERSION_NUM >= 180000
+      if (((MergeAppend*) plan)->part_prune_index >= 0)
+#else
+      if (((MergeAppend*) plan)->part_prune_info != NULL)
+#endif
+        return false;
+      foreach (cell, ((MergeAppend*) plan)->mergeplans) {
+        if (db2PlanReads ((Plan*) lfirst (cell), scan))
+          return true;
+      }
+      return false;
+    default:
+      return false;
+  }
+}
@@ -1,5 +1,6 @@
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <sqlcli1.h>
 #include <postgres_ext.h>
 #include "db2_fdw.h"
@@ -11,10 +12,6 @@
 extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
 
 /** external prototypes */
-extern void*        db2alloc             (const char* type, size_t size);
-extern void         db2Debug1            (const char* message, ...);
-extern void         db2Debug2            (const char* message, ...);
-extern void         db2Debug3            (const char* message, ...);
 extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
 extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
 extern SQLSMALLINT  param2c              (SQLSMALLINT fcType);
@@ -29,7 +26,9 @@ void db2BindParameter (DB2Session* session, const DB2Table* db2Table, ParamDesc*
   db2Debug1("> db2BindParameter");
   db2Debug2("  param_count     : %d",param_count);
   db2Debug2("  col_num         : %d",col_num);
-  db2Debug2("  param->value    : %s",param->value);
+  if (param->native == NATIVE_NONE && param->bindType != BIND_LONG && param->bindType != BIND_LONGRAW) {
+    db2Debug2("  param->value    : %s",param->value);
+  }
   db2Debug2("  param->colnum   : %d",param->colnum);
   db2Debug2("  param->bindType : %d",param->bindType);
   if (param->colnum >= 0) {
@@ -37,107 +36,115 @@ void db2BindParameter (DB2Session* session, const DB2Table* db2Table, ParamDesc*
   }
   switch (param->bindType) {
       case BIND_NUMBER: {
+        /* parameters of a SELECT have no DB2 column, let DB2 derive the type from the value */
+        SQLSMALLINT sqlType = (param->colnum >= 0) ? db2Table->cols[param->colnum]->colType  : SQL_UNKNOWN_TYPE;
+        SQLULEN     colSize = (param->colnum >= 0) ? db2Table->cols[param->colnum]->colSize  : 0;
+        SQLSMALLINT scale   = (param->colnum >= 0) ? db2Table->cols[param->colnum]->colScale : 0;
         db2Debug3("  param->bindType: BIND_NUMBER");
         *indicator = (SQLLEN) ((param->value == NULL) ? SQL_NULL_DATA : 0);
         db2Debug2("  param_ind       : %d",*indicator);
-        db2Debug2("  colType         : %d - %s",db2Table->cols[param->colnum]->colType,c2name(db2Table->cols[param->colnum]->colType));
-        switch (db2Table->cols[param->colnum]->colType) {
-          case SQL_BIGINT:{
-            char*      end     = NULL;
-            SQLBIGINT* sqlbint = NULL;
-            if (param->value != NULL) {
-              sqlbint  = db2alloc("SQLBIGINT",sizeof(SQLBIGINT));
-              *sqlbint = strtoll(param->value,&end,10);
-              db2Debug2("  sqlbint: %d",*sqlbint);
+        db2Debug2("  colType         : %d - %s",sqlType,c2name(sqlType));
+        if (param->native == NATIVE_INT64) {
+          /* the value was stored in binary form, no conversion needed */
+          db2Debug2("  ival            : %lld",param->buf.ival);
+          rc = SQLBindParameter( session->stmtp->hsql
+                               , col_num
+                               , SQL_PARAM_INPUT
+                               , SQL_C_SBIGINT
+                               , (sqlType == SQL_UNKNOWN_TYPE) ? SQL_BIGINT : sqlType
+                               , colSize
+                               , scale
+                               , &param->buf.ival
+                               , 0
+                               , indicator
+                               );
+        } else if (param->native == NATIVE_DOUBLE) {
+          db2Debug2("  dval            : %g",param->buf.dval);
+          rc = SQLBindParameter( session->stmtp->hsql
+                               , col_num
+                               , SQL_PARAM_INPUT
+                               , SQL_C_DOUBLE
+                               , (sqlType == SQL_UNKNOWN_TYPE) ? SQL_DOUBLE : sqlType
+                               , colSize
+                               , scale
+                               , &param->buf.dval
+                               , 0
+                               , indicator
+                               );
+        } else {
+          switch (sqlType) {
+            case SQL_BIGINT:
+            case SQL_SMALLINT:
+            case SQL_INTEGER: {
+              /* parse the string into the preallocated buffer */
+              char* end = NULL;
+              if (param->value != NULL) {
+                param->buf.ival = strtoll(param->value,&end,10);
+                db2Debug2("  ival: %lld",param->buf.ival);
+              }
+              rc = SQLBindParameter( session->stmtp->hsql
+                                   , col_num
+                                   , SQL_PARAM_INPUT
+                                   , SQL_C_SBIGINT
+                                   , sqlType
+                                   , 0
+                                   , 0
+                                   , &param->buf.ival
+                                   , 0
+                                   , indicator
+                                   );
             }
-            rc = SQLBindParameter( session->stmtp->hsql
-                                 , col_num
-                                 , SQL_PARAM_INPUT
-                                 , SQL_C_SBIGINT
-                                 , db2Table->cols[param->colnum]->colType
-                                 , 0
-                                 , 0
-                                 , sqlbint
-                                 , 0
-                                 , indicator
-                                 );
-          }
-          break;
-          case SQL_SMALLINT:{
-            char*        end     = NULL;
-            SQLSMALLINT* sqlsint = NULL;
-            if (param->value != NULL) {
-              sqlsint  = db2alloc("SQLSMALLINT",sizeof(SQLSMALLINT));
-              *sqlsint = strtol(param->value,&end,10);
-              db2Debug2("  sqlsint: %d",*sqlsint);
+            break;
+            case SQL_DECIMAL:
+            case SQL_NUMERIC:
+            case SQL_FLOAT:
+            case SQL_REAL:
+            case SQL_DOUBLE:
+            case SQL_DECFLOAT: {
+              SQL_NUMERIC_STRUCT* num = (SQL_NUMERIC_STRUCT*) param->buf.raw;
+              if (param->value != NULL) {
+                parse2num_struct(param->value, num);
+                colSize = num->precision;
+                scale   = num->scale;
+              }
+              rc = SQLBindParameter( session->stmtp->hsql
+                                   , col_num
+                                   , SQL_PARAM_INPUT
+                                   , SQL_C_NUMERIC
+                                   , sqlType
+                                   , colSize
+                                   , scale
+                                   , num
+                                   , sizeof(*num)
+                                   , indicator
+                                   );
             }
-            rc = SQLBindParameter( session->stmtp->hsql
-                                 , col_num
-                                 , SQL_PARAM_INPUT
-                                 , SQL_C_SSHORT
-                                 , db2Table->cols[param->colnum]->colType
-                                 , 0
-                                 , 0
-                                 , sqlsint
-                                 , 0
-                                 , indicator
-                                 );
-          }
-          break;
-          case SQL_INTEGER: {
-            char*       end    = NULL;
-            SQLINTEGER* sqlint = NULL;
-            if (param->value != NULL) {
-              sqlint  = db2alloc("SQLINTEGER",sizeof(SQLINTEGER));
-              *sqlint = strtol(param->value,&end,10);
-              db2Debug2("  sqlint: %d",*sqlint);
+            break;
+            case SQL_UNKNOWN_TYPE: {
+              /* a NUMERIC parameter of a SELECT, pass it on as string */
+              *indicator = (SQLLEN) ((param->value == NULL) ? SQL_NULL_DATA : SQL_NTS);
+              rc = SQLBindParameter( session->stmtp->hsql
+                                   , col_num
+                                   , SQL_PARAM_INPUT
+                                   , SQL_C_CHAR
+                                   , SQL_VARCHAR
+                                   , (param->value == NULL) ? 1 : strlen(param->value) + 1
+                                   , 0
+                                   , (SQLPOINTER) param->value
+                                   , 0
+                                   , indicator
+                                   );
             }
-            rc = SQLBindParameter( session->stmtp->hsql
-                                 , col_num
-                                 , SQL_PARAM_INPUT
-                                 , SQL_C_SLONG
-                                 , db2Table->cols[param->colnum]->colType
-                                 , 0
-                                 , 0
-                                 , sqlint
-                                 , 0
-                                 , indicator
-                                 );
-          }
-          break;
-          case SQL_DECIMAL:
-          case SQL_NUMERIC:
-          case SQL_FLOAT:
-          case SQL_REAL:
-          case SQL_DOUBLE:
-          case SQL_DECFLOAT: {
-            SQL_NUMERIC_STRUCT* num = NULL;
-            if (param->value != NULL) {
-              num = db2alloc("SQL_NUMERIC_STRUCT",sizeof(SQL_NUMERIC_STRUCT));
-              parse2num_struct(param->value, num);
-              db2Debug2("  num: '%s'",*num);
+            break;
+            default: {
+              snprintf(db2Message,ERRBUFSIZE,"unsupported sql number type: %d - %s"
+                      ,sqlType
+                      ,c2name(sqlType)
+                      ); 
+              db2Error_d(FDW_UNABLE_TO_CREATE_EXECUTION, "error executing isrt query: unable to bind parameter", db2Message);
             }
-            rc = SQLBindParameter( session->stmtp->hsql
-                                 , col_num
-                                 , SQL_PARAM_INPUT
-                                 , SQL_C_NUMERIC
-                                 , db2Table->cols[param->colnum]->colType
-                                 , num->precision
-                                 , num->scale
-                                 , num
-                                 , sizeof(*num)
-                                 , indicator
-                                 );
-          }
-          break;
-          default: {
-            snprintf(db2Message,ERRBUFSIZE,"unsupported sql number type: %d - %s"
-                    ,db2Table->cols[param->colnum]->colType
-                    ,c2name(db2Table->cols[param->colnum]->colType)
-                    ); 
-            db2Error_d(FDW_UNABLE_TO_CREATE_EXECUTION, "error executing isrt query: unable to bind parameter", db2Message);
+            break;
           }
-          break;
         }
       }
       break;
@@ -145,12 +152,13 @@ void db2BindParameter (DB2Session* session, const DB2Table* db2Table, ParamDesc*
         db2Debug3("  param->bindType: BIND_STRING");
         *indicator = (SQLLEN) ((param->value == NULL) ? SQL_NULL_DATA : SQL_NTS);
         db2Debug2("  param_ind       : %d",*indicator);
+        /* bind fixed length columns as such, so that DB2 compares them without conversion */
         rc = SQLBindParameter( session->stmtp->hsql
                              , col_num
                              , SQL_PARAM_INPUT
                              , SQL_C_CHAR
-                             , SQL_VARCHAR
-                             , db2Table->cols[param->colnum]->colSize
+                             , (param->colnum >= 0 && db2Table->cols[param->colnum]->colType == SQL_CHAR) ? SQL_CHAR : SQL_VARCHAR
+                             , (param->colnum >= 0) ? db2Table->cols[param->colnum]->colSize : ((param->value == NULL) ? 1 : strlen(param->value) + 1)
                              , 0
                              , (SQLPOINTER) param->value
                              , 0
@@ -160,7 +168,8 @@ void db2BindParameter (DB2Session* session, const DB2Table* db2Table, ParamDesc*
       break;
       case BIND_LONGRAW: {
         db2Debug3("  param->bindType: BIND_LONGRAW");
-        *indicator = (SQLLEN) ((param->value == NULL) ? SQL_NULL_DATA : SQL_NTS);
+        /* the data are sent with SQLPutData during execution, param serves as token */
+        *indicator = (SQLLEN) ((param->value == NULL) ? SQL_NULL_DATA : SQL_LEN_DATA_AT_EXEC (param->value_len));
         db2Debug2("  param_ind       : %d",*indicator);
         rc = SQLBindParameter( session->stmtp->hsql
                              , col_num
@@ -169,7 +178,7 @@ void db2BindParameter (DB2Session* session, const DB2Table* db2Table, ParamDesc*
                              , SQL_LONGVARBINARY
                              , db2Table->cols[param->colnum]->colSize
                              , 0
-                             , (SQLPOINTER) param->value
+                             , (SQLPOINTER) param
                              , 0
                              , indicator
                              );
@@ -177,9 +186,10 @@ void db2BindParameter (DB2Session* session, const DB2Table* db2Table, ParamDesc*
       break;
       case BIND_LONG: {
         db2Debug3("  param->bindType: BIND_LONG");
-        *indicator = (SQLLEN) ((param->value == NULL) ? SQL_NULL_DATA : SQL_NTS);
+        /* the data are sent with SQLPutData during execution, param serves as token */
+        *indicator = (SQLLEN) ((param->value == NULL) ? SQL_NULL_DATA : SQL_LEN_DATA_AT_EXEC (param->value_len));
         db2Debug2("  param_ind       : %d",*indicator);
-        db2Debug2("  param->value    : '%s'",param->value);
+        db2Debug2("  param->value_len: %ld",param->value_len);
         rc = SQLBindParameter( session->stmtp->hsql
                              , col_num
                              , SQL_PARAM_INPUT
@@ -187,7 +197,7 @@ void db2BindParameter (DB2Session* session, const DB2Table* db2Table, ParamDesc*
                              , SQL_LONGVARCHAR
                              , db2Table->cols[param->colnum]->colSize
                              , 0
-                             , (SQLPOINTER) param->value
+                             , (SQLPOINTER) param
                              , 0
                              , indicator
                              );
@@ -1,43 +1,43 @@
 #include <postgres.h>
 #include <utils/elog.h>
 #include <access/xact.h>
+#include "db2_fdw.h"
+
+/** global variables */
+bool db2ParallelCommit     = false; /* set by db2_fdw.parallel_commit                 */
+bool db2CallbackRegistered = false; /* the callbacks are registered once per backend */
 
 /** eternal variables */
 extern bool dml_in_transaction;
 
 /** external prototypes */
-extern void         db2EndTransaction         (void* arg, int is_commit, int noerror);
-extern void         db2EndSubtransaction      (void* arg, int nest_level, int is_commit);
-extern void         db2Debug1                 (const char* message, ...);
+extern void         db2EndAllTransactions     (int is_commit, int noerror, int parallel);
+extern void         db2EndAllSubtransactions  (int nest_level, int is_commit);
+extern void         db2QuerySlotReleaseAll    (void);
+extern void         db2ReadRouteReset         (void);
 
 /** local prototypes */
-void db2RegisterCallback   (void* arg);
-void db2UnregisterCallback (void* arg);
+void db2RegisterCallback   (void);
 void transactionCallback   (XactEvent event, void *arg);
 void subtransactionCallback(SubXactEvent event, SubTransactionId mySubid, SubTransactionId parentSubid, void* arg);
 
 /** db2RegisterCallback
- *   Register a callback for PostgreSQL transaction events.
+ *   Register the callbacks for PostgreSQL transaction events.
+ *   They are registered once, with the first connection, and handle all
+ *   cached connections, so closing a connection does not have to unregister anything.
  */
-void db2RegisterCallback (void *arg) {
-  db2Debug1("> db2RegisterCallback(%x)",arg);
-  RegisterXactCallback (transactionCallback, arg);
-  RegisterSubXactCallback (subtransactionCallback, arg);
+void db2RegisterCallback (void) {
+  if (db2CallbackRegistered)
+    return;
+  db2Debug1("> db2RegisterCallback");
+  RegisterXactCallback (transactionCallback, NULL);
+  RegisterSubXactCallback (subtransactionCallback, NULL);
+  db2CallbackRegistered = true;
   db2Debug1("< db2RegisterCallback");
 }
 
-/** db2UnregisterCallback
- *   Unregister a callback for PostgreSQL transaction events.
- */
-void db2UnregisterCallback (void *arg) {
-  db2Debug1("> db2UnregisterCallback(%x)",arg);
-  UnregisterXactCallback (transactionCallback, arg);
-  UnregisterSubXactCallback (subtransactionCallback, arg);
-  db2Debug1("< db2UnregisterCallback");
-}
-
 /** transactionCallback
- *   Commit or rollback DB2 transactions when appropriate.
+ *   Commit or rollback the DB2 transactions of all connections when appropriate.
  */
 void transactionCallback (XactEvent event, void *arg) {
   db2Debug1("> transactionCallback");
@@ -45,7 +45,7 @@ void transactionCallback (XactEvent event, void *arg) {
     case XACT_EVENT_PRE_COMMIT:
     case XACT_EVENT_PARALLEL_PRE_COMMIT:
       /* remote commit */
-      db2EndTransaction (arg, 1, 0);
+      db2EndAllTransactions (1, 0, db2ParallelCommit);
     break;
     case XACT_EVENT_PRE_PREPARE:
       ereport (ERROR, (errcode (ERRCODE_FDW_UNABLE_TO_CREATE_EXECUTION), errmsg ("cannot prepare a transaction that used remote tables")));
@@ -58,12 +58,17 @@ void transactionCallback (XactEvent event, void *arg) {
        * In 9.3 or higher, the transaction must already be closed, so this does nothing.
        * In 9.2 or lower, this is ok since nothing can have been modified remotely.
        */
-      db2EndTransaction (arg, 1, 1);
+      db2EndAllTransactions (1, 1, db2ParallelCommit);
+      db2QuerySlotReleaseAll ();
+      db2ReadRouteReset ();
     break;
     case XACT_EVENT_ABORT:
     case XACT_EVENT_PARALLEL_ABORT:
       /* remote rollback */
-      db2EndTransaction (arg, 0, 1);
+      db2EndAllTransactions (0, 1, db2ParallelCommit);
+      /* scans that ended with an error still hold their admission */
+      db2QuerySlotReleaseAll ();
+      db2ReadRouteReset ();
     break;
   }
   dml_in_transaction = false;
@@ -77,6 +82,6 @@ void subtransactionCallback (SubXactEvent event, SubTransactionId mySubid, SubTr
     db2Debug1("> subtransactionCallback");
   /* rollback to the appropriate savepoint on subtransaction abort */
   if (event == SUBXACT_EVENT_ABORT_SUB || event == SUBXACT_EVENT_PRE_COMMIT_SUB)
-    db2EndSubtransaction (arg, GetCurrentTransactionNestLevel (), event == SUBXACT_EVENT_PRE_COMMIT_SUB);
+    db2EndAllSubtransactions (GetCurrentTransactionNestLevel (), event == SUBXACT_EVENT_PRE_COMMIT_SUB);
   db2Debug1("< subtransactionCallback");
 }
@@ -8,20 +8,20 @@
 extern DB2EnvEntry* rootenvEntry;          /* contains DB2 error messages, set by db2CheckErr()             */
 
 /** external prototypes */
-extern void      db2Debug1            (const char* message, ...);
 
 /** local prototypes */
 void             db2Cancel            (void);
 
 /** db2Cancel
  *   Cancel all running DB2 queries.
+ *   This is called from signal handlers, so it must not trace, allocate
+ *   or report errors; it only walks the handle lists and calls SQLCancel.
  */
 void db2Cancel (void) {
   DB2EnvEntry*  envp  ;
   DB2ConnEntry* connp ;
   HdlEntry*     entryp;
 
-  db2Debug1("> db2Cancel");
   /* send a cancel request for all servers ignoring errors */
   for (envp = rootenvEntry; envp != NULL; envp = envp->right) {
     for (connp = envp->connlist; connp != NULL; connp = connp->right) {
@@ -32,5 +32,4 @@ void db2Cancel (void) {
       }
     }
   }
-  db2Debug1("< db2Cancel");
 }
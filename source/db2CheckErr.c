@@ -7,22 +7,24 @@
 /** global variables  */
 int                 err_code = 0;          /* error code, set by db2CheckErr()                              */
 char                db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
+DB2Diag             db2Diag;               /* structured diagnostics of the last failed call                */
 
 /** external variables */
 
 /** external prototypes */
-extern void      db2Debug4            (const char* message, ...);
-extern void      db2Debug5            (const char* message, ...);
 
 /** local prototypes */
 SQLRETURN db2CheckErr (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
+void      db2GetDiag  (SQLHANDLE handle, SQLSMALLINT handleType);
 
 /** db2CheckErr
  *    Call SQLGetDiagRec to get sqlcode, sqlstate and db2 error message.
  *    It sets the global err_code with a value, so subsequent code can evaluate.
- *    It populates the db2Message with SQLCODE, SQLSTATE and the DB2 message text.
+ *    It populates db2Diag with the SQLSTATE and SQLCODE of the first record
+ *    and db2Message with SQLCODE, SQLSTATE and the DB2 message text of all records.
  *    It modifys the result to SQL_SUCCESS in case the status was SQL_SUCCESS_WITH_INFO.
  *    It sets err_code to 100 upon SQL_NO_DATA.
+ *    SQL_SUCCESS is returned right away, diagnostics are only collected on failure.
  * 
  *  @param status     the returncode from a previous executed SQL API call
  *  @param handle     the handle used in that previous SQL API call
@@ -34,8 +36,15 @@ SQLRETURN db2CheckErr (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleTyp
  *  @since  1.0.0
  */
 SQLRETURN db2CheckErr (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file) {
+  /* fast path: this is called after every CLI call, including each fetch */
+  if (status == SQL_SUCCESS) {
+    db2Message[0] = '\0';
+    db2Diag.nrecs = 0;
+    return status;
+  }
   db2Debug4("> db2CheckErr");
-  memset (db2Message,0x00,sizeof(db2Message));
+  db2Message[0] = '\0';
+  db2Diag.nrecs = 0;
   switch (status) {
     case SQL_INVALID_HANDLE: {
       snprintf(db2Message,ERRBUFSIZE,"-CI INVALID HANDLE-----\nline=%d\nfile=%s\n",line,file);
@@ -43,35 +52,12 @@ SQLRETURN db2CheckErr (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleTyp
     }
     break;
     case SQL_ERROR: {
-      SQLCHAR     message    [SQL_MAX_MESSAGE_LENGTH];
-      SQLCHAR     submessage [SUBMESSAGE_LEN];
-      SQLCHAR     sqlstate   [SQLSTATE_LEN];
-      SQLINTEGER  sqlcode;
-      SQLSMALLINT msgLen;
-      int         i = 1;
-
-      memset(submessage,0x00,SUBMESSAGE_LEN);
-      memset(message   ,0x00,SQL_MAX_MESSAGE_LENGTH);
- 
-      while (SQL_SUCCEEDED(SQLGetDiagRec(handleType,handle,i,sqlstate,&sqlcode,message,SQL_MAX_MESSAGE_LENGTH,&msgLen))) {
-        db2Debug5("  SQLCODE :  %d ",sqlcode);
-        db2Debug5("  SQLSTATE:  %d ",sqlstate);
-        db2Debug5("  MESSAGE : '%s'",message);
-        snprintf((char*)submessage, SUBMESSAGE_LEN, "SQLSTATE = %s  SQLCODE = %d\nline=%d\nfile=%s\n", sqlstate,sqlcode,line,file);
-        if ((sizeof(db2Message) - strlen((char*)db2Message)) > strlen((char*)submessage) + 1) {
-          strncat ((char*)db2Message,(char*)submessage, SUBMESSAGE_LEN);
-        }
-        if ((sizeof(db2Message) - strlen((char*)db2Message)) > strlen((char*)message) + 2) {
-          strncat ((char*)db2Message,(char*)message,SQL_MAX_MESSAGE_LENGTH);
-          strncat ((char*)db2Message,"\n",strlen("\n"));
-        }
-        if (i == 1) {
-          err_code = ((sqlcode == -911 || sqlcode == -913) && strcmp((char*)sqlstate,"40001") == 0) ? 8177 : abs(sqlcode);
-        }
-        i++;
-        memset(submessage,0x00,SUBMESSAGE_LEN);
-        memset(message   ,0x00,SQL_MAX_MESSAGE_LENGTH);
-      }
+      memset (&db2Diag, 0x00, sizeof(db2Diag));
+      db2Diag.status = status;
+      db2Diag.line   = line;
+      db2Diag.file   = file;
+      db2GetDiag(handle, handleType);
+      err_code = ((db2Diag.sqlcode == -911 || db2Diag.sqlcode == -913) && strcmp(db2Diag.sqlstate,"40001") == 0) ? 8177 : abs(db2Diag.sqlcode);
     }
     break;
     case SQL_SUCCESS_WITH_INFO: {
@@ -90,3 +76,35 @@ SQLRETURN db2CheckErr (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleTyp
   db2Debug4("< db2CheckErr - returns: %d",status);
   return status;
 }
+
+/** db2GetDiag
+ *    Read all diagnostic records of the handle into db2Diag and db2Message.
+ *    The location of the failed call is added once after the records.
+ */
+void db2GetDiag (SQLHANDLE handle, SQLSMALLINT handleType) {
+  SQLCHAR     message    [SQL_MAX_MESSAGE_LENGTH];
+  SQLCHAR     sqlstate   [SQLSTATE_LEN];
+  SQLINTEGER  sqlcode;
+  SQLSMALLINT msgLen;
+  size_t      len = 0;
+  int         i   = 1;
+
+  while (SQL_SUCCEEDED(SQLGetDiagRec(handleType,handle,i,sqlstate,&sqlcode,message,SQL_MAX_MESSAGE_LENGTH,&msgLen))) {
+    db2Debug5("  SQLCODE :  %d ",sqlcode);
+    db2Debug5("  SQLSTATE:  %s ",sqlstate);
+    db2Debug5("  MESSAGE : '%s'",message);
+    if (i == 1) {
+      strncpy(db2Diag.sqlstate, (char*)sqlstate, SQLSTATE_LEN - 1);
+      db2Diag.sqlcode = sqlcode;
+    }
+    if (len < sizeof(db2Message)) {
+      int n = snprintf(db2Message + len, sizeof(db2Message) - len, "SQLSTATE = %s  SQLCODE = %d\n%s\n", sqlstate, sqlcode, message);
+      len += (n > 0) ? (size_t) n : 0;
+    }
+    db2Diag.nrecs = i;
+    i++;
+  }
+  if (len < sizeof(db2Message)) {
+    snprintf(db2Message + len, sizeof(db2Message) - len, "line=%d\nfile=%s\n", db2Diag.line, db2Diag.file);
+  }
+}
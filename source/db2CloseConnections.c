@@ -11,20 +11,19 @@ extern DB2EnvEntry* rootenvEntry;          /* Linked list of handles for cached
 extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
 
 /** external prototypes */
-extern void      db2Debug1            (const char* message, ...);
-extern void      db2Debug2            (const char* message, ...);
-extern void      db2Debug3            (const char* message, ...);
 extern void      db2Error             (db2error sqlstate, const char* message);
 extern void      db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
 extern SQLRETURN db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
-extern void      db2UnregisterCallback(void* arg);
 extern void      db2FreeEnvHdl        (DB2EnvEntry* envp, const char* nls_lang);
 extern void      db2free              (void* p);
+extern void      db2WaitStart         (db2WaitEvent event);
+extern void      db2WaitEnd           (void);
+extern void      db2ConnSlotRelease   (const char* dbserver);
 
 /** local prototypes */
 void             db2CloseConnections  (void);
 void             db2FreeConnHdl       (DB2EnvEntry* envp, DB2ConnEntry* connp);
-int              deleteconnEntry      (DB2ConnEntry* start, DB2ConnEntry* node);
+int              deleteconnEntry      (DB2EnvEntry* envp, DB2ConnEntry* node);
 
 /** db2CloseConnections
  *    Close everything in the cache.
@@ -56,10 +55,17 @@ void db2FreeConnHdl(DB2EnvEntry* envp, DB2ConnEntry* connp){
     else db2Error (FDW_ERROR, "closeSession internal error: connp is null");
   }
 
+  /* end a pending unit of work, otherwise SQLDisconnect fails; never commit modifications here */
+  db2WaitStart (DB2_WAIT_COMMIT);
+  rc = SQLEndTran(SQL_HANDLE_DBC, connp->hdbc, connp->xact_dirty ? SQL_ROLLBACK : SQL_COMMIT);
+  db2WaitEnd ();
+  db2Debug3("  SQLEndTran.rc: %d",rc);
+
   /* terminate the session */
   db2Debug2("  connp->hdbc: %x",connp->hdbc);
   rc = SQLDisconnect(connp->hdbc);
   db2Debug3("  SQLDisconnect.rc: %d",rc);
+  db2ConnSlotRelease (connp->srvname);
   rc = db2CheckErr(rc, connp->hdbc,SQL_HANDLE_DBC,__LINE__,__FILE__);
   if (rc != SQL_SUCCESS && !silent) {
     db2Error_d (FDW_UNABLE_TO_CREATE_REPLY, "error closing session: SQLDisconnect failed to terminate session", db2Message);
@@ -72,56 +78,42 @@ void db2FreeConnHdl(DB2EnvEntry* envp, DB2ConnEntry* connp){
   if (rc != SQL_SUCCESS && !silent) {
     db2Error_d (FDW_UNABLE_TO_CREATE_REPLY, "error freeing session handle: SQLFreeHandle failed", db2Message);
   }
-  /* unregister callback for rolled back transactions */
-  db2UnregisterCallback (connp);
-
   /* remove the session handle from the cache */
-  result = deleteconnEntry(envp->connlist, connp);
-  if (result && envp->connlist == connp) {
-    envp->connlist = NULL;
-    db2Debug3("  envp->connlist: %x",envp->connlist);
-  }
+  result = deleteconnEntry(envp, connp);
+  db2Debug3("  deleteconnEntry: %d, envp->connlist: %x",result,envp->connlist);
 
   db2Debug1("< db2FreeConnHdl");
 }
 
 /** deleteconnEntry
- * 
+ *   Unlink a connection from the list and the hash table of "envp" and free it.
  */
-int deleteconnEntry(DB2ConnEntry* start, DB2ConnEntry* node) {
-  int           result = 0;
-  DB2ConnEntry* step   = NULL;
-  db2Debug1("> deleteconnEntry(start:%x,node:%x)",start,node);
+int deleteconnEntry(DB2EnvEntry* envp, DB2ConnEntry* node) {
+  int            result = 0;
+  DB2ConnEntry** link   = NULL;
+  db2Debug1("> deleteconnEntry(envp:%x,node:%x)",envp,node);
 
-  for (step = start; step != NULL; step = step->right) {
-    if (step == node) {
-      db2Debug3("  step == node: start: %x, step: %x, node %x", start, step, node);
-      if (step->left == NULL && step->right == NULL){
-        db2Debug3("  step left and right is null: start: %x, step: %x",start,step);
-      } else if (step->left == NULL) {
-        db2Debug3("  step left null");
-        step->right->left = NULL;
-      } else if (step->right == NULL) {
-        db2Debug3("  step right null");
-        step->left->right = NULL;
-      } else {
-        step->left->right = step->right;
-        step->right->left = step->left;
-      }
-      if (step->srvname)   free (step->srvname);
-      if (step->uid)       free (step->uid);
-      if (step->pwd)       free (step->pwd);
-      if (step->jwt_token) free (step->jwt_token);
-      if (step) {
-        db2Debug1("  DB2ConnEntry freed: %x", step);
-        free (step);
-      }
+  /* the hash bucket tells whether the entry belongs to this environment */
+  for (link = &envp->connhash[node->hash % DB2_CONN_HASH_SIZE]; *link != NULL; link = &(*link)->hnext) {
+    if (*link == node) {
+      *link = node->hnext;
       result = 1;
       break;
     }
   }
-  for (step = start; step != NULL; step = step->right) {
-    db2Debug3("  start:%x, step:%x, step->left: %x, step->right:%x",start,step,step->left,step->right);
+  if (result) {
+    if (node->left == NULL)
+      envp->connlist = node->right;
+    else
+      node->left->right = node->right;
+    if (node->right != NULL)
+      node->right->left = node->left;
+    if (node->srvname)   free (node->srvname);
+    if (node->uid)       free (node->uid);
+    if (node->pwd)       free (node->pwd);
+    if (node->jwt_token) free (node->jwt_token);
+    db2Debug1("  DB2ConnEntry freed: %x", node);
+    free (node);
   }
   db2Debug1("< deleteconnEntry - returns: %d", result);
   return result;
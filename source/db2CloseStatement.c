@@ -7,8 +7,6 @@
 /** external variables */
 
 /** external prototypes */
-extern void      db2Debug1            (const char* message, ...);
-extern void      db2Debug3            (const char* message, ...);
 extern void      db2FreeStmtHdl       (HdlEntry* handlep, DB2ConnEntry* connp);
 
 /** local prototypes */
@@ -0,0 +1,144 @@
+#include <string.h>
+#include <time.h>
+#include <sqlcli1.h>
+#include <postgres_ext.h>
+#include "db2_fdw.h"
+
+/** global variables */
+int                 db2ConnIdleTimeout   = 0;                           /* seconds, set by db2_fdw.connection_idle_timeout   */
+int                 db2ConnCheckInterval = DEFAULT_CONN_CHECK_INTERVAL; /* seconds, set by db2_fdw.connection_check_interval */
+
+/** external variables */
+extern int          silent;                /* emit no error messages when set, used for shutdown            */
+extern DB2EnvEntry* rootenvEntry;          /* Linked list of handles for cached DB2 connections.            */
+extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
+
+/** external prototypes */
+extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
+extern void         db2FreeConnHdl       (DB2EnvEntry* envp, DB2ConnEntry* connp);
+extern void         db2WaitStart         (db2WaitEvent event);
+extern void         db2WaitEnd           (void);
+
+/** local prototypes */
+void                db2ReapConnections   (DB2ConnEntry* keep);
+int                 db2PingConnection    (DB2ConnEntry* connp);
+void                db2DropConnection    (DB2EnvEntry* envp, DB2ConnEntry* connp);
+void                db2DropIdleConnections(const char* srvname);
+int                 db2ConnStats         (DB2ConnStat* stats, int max);
+
+/** db2ReapConnections
+ *   Close all cached connections that have not been used for
+ *   db2_fdw.connection_idle_timeout seconds, except "keep".
+ *   Connections that take part in the current transaction are never closed.
+ */
+void db2ReapConnections (DB2ConnEntry* keep) {
+  DB2EnvEntry*  envp  = NULL;
+  DB2ConnEntry* connp = NULL;
+  DB2ConnEntry* next  = NULL;
+  time_t        now   = 0;
+
+  if (db2ConnIdleTimeout <= 0)
+    return;
+  db2Debug1("> db2ReapConnections");
+  now = time(NULL);
+  for (envp = rootenvEntry; envp != NULL; envp = envp->right) {
+    for (connp = envp->connlist; connp != NULL; connp = next) {
+      next = connp->right;
+      if (connp == keep || connp->xact_level > 0 || connp->handlelist != NULL)
+        continue;
+      if (now - connp->last_used >= db2ConnIdleTimeout) {
+        db2Debug2("  closing connection to '%s' idle for %ld seconds", connp->srvname ? connp->srvname : "", (long) (now - connp->last_used));
+        db2DropConnection (envp, connp);
+      }
+    }
+  }
+  db2Debug1("< db2ReapConnections");
+}
+
+/** db2PingConnection
+ *   Check with SQL_ATTR_PING_DB whether the server still answers on a
+ *   cached connection.  Returns 1 if the connection is usable, else 0.
+ */
+int db2PingConnection (DB2ConnEntry* connp) {
+  int        alive = 1;
+#ifdef SQL_ATTR_PING_DB
+  SQLRETURN  rc    = 0;
+  SQLINTEGER ptime = 0;
+
+  db2Debug1("> db2PingConnection");
+  connp->pings++;
+  db2WaitStart (DB2_WAIT_PING);
+  rc = SQLGetConnectAttr(connp->hdbc, SQL_ATTR_PING_DB, &ptime, 0, NULL);
+  db2WaitEnd ();
+  rc = db2CheckErr(rc, connp->hdbc, SQL_HANDLE_DBC, __LINE__, __FILE__);
+  alive = (rc == SQL_SUCCESS);
+  db2Debug2("  ping time: %d microseconds, alive: %d", (int) ptime, alive);
+  if (!alive)
+    db2Debug2("  %s", db2Message);
+  db2Debug1("< db2PingConnection - returns: %d", alive);
+#endif
+  return alive;
+}
+
+/** db2DropConnection
+ *   Close a cached connection that is idle or broken, ignoring errors.
+ */
+void db2DropConnection (DB2EnvEntry* envp, DB2ConnEntry* connp) {
+  int save_silent = silent;
+
+  silent = 1;
+  db2FreeConnHdl (envp, connp);
+  silent = save_silent;
+}
+
+/** db2DropIdleConnections
+ *   Close all cached connections to "srvname" that are not used by the
+ *   current transaction, regardless of their idle time.
+ *   Used to free a slot when db2_fdw.max_connections is reached.
+ */
+void db2DropIdleConnections (const char* srvname) {
+  DB2EnvEntry*  envp  = NULL;
+  DB2ConnEntry* connp = NULL;
+  DB2ConnEntry* next  = NULL;
+  const char*   name  = (srvname != NULL) ? srvname : "";
+
+  db2Debug1("> db2DropIdleConnections");
+  for (envp = rootenvEntry; envp != NULL; envp = envp->right) {
+    for (connp = envp->connlist; connp != NULL; connp = next) {
+      next = connp->right;
+      if (connp->xact_level > 0 || connp->handlelist != NULL)
+        continue;
+      if (strcmp ((connp->srvname != NULL) ? connp->srvname : "", name) == 0)
+        db2DropConnection (envp, connp);
+    }
+  }
+  db2Debug1("< db2DropIdleConnections");
+}
+
+/** db2ConnStats
+ *   Copy the statistics of at most "max" cached connections to "stats".
+ *   Returns the number of cached connections, which may exceed "max".
+ */
+int db2ConnStats (DB2ConnStat* stats, int max) {
+  DB2EnvEntry*  envp  = NULL;
+  DB2ConnEntry* connp = NULL;
+  int           count = 0;
+
+  for (envp = rootenvEntry; envp != NULL; envp = envp->right) {
+    for (connp = envp->connlist; connp != NULL; connp = connp->right, ++count) {
+      if (count >= max)
+        continue;
+      stats[count].srvname   = connp->srvname;
+      stats[count].uid       = connp->uid;
+      stats[count].nls_lang  = envp->nls_lang;
+      stats[count].connected = connp->connected;
+      stats[count].last_used = connp->last_used;
+      stats[count].uses      = connp->uses;
+      stats[count].commits   = connp->commits;
+      stats[count].rollbacks = connp->rollbacks;
+      stats[count].pings     = connp->pings;
+      stats[count].in_xact   = (connp->xact_level > 0);
+    }
+  }
+  return count;
+}
@@ -0,0 +1,416 @@
+#include <postgres.h>
+#include <funcapi.h>
+#include <miscadmin.h>
+#include <portability/instr_time.h>
+#include <storage/condition_variable.h>
+#include <storage/ipc.h>
+#include <storage/lwlock.h>
+#include <storage/shmem.h>
+#include <utils/builtins.h>
+#include <utils/tuplestore.h>
+#include "db2_fdw.h"
+#include "DB2ConnSlot.h"
+
+/** number of columns of db2_fdw_server_stats */
+#define DB2_SERVER_COLS 6
+
+/** global variables */
+int                        db2MaxConnections = 0;    /* set by db2_fdw.max_connections, 0 = no limit */
+int                        db2ConnWaitTimeout = DEFAULT_CONN_WAIT_TIMEOUT; /* milliseconds, set by db2_fdw.connection_wait_timeout */
+DB2ConnSlots*              db2ConnSlots      = NULL; /* NULL unless loaded at server start            */
+int                        db2ConnSlotHeld[DB2_CONN_SLOTS]; /* connections this backend holds per slot */
+int                        db2QuerySlotHeld[DB2_CONN_SLOTS];/* scans of this backend admitted per slot  */
+bool                       db2ConnSlotExitSet = false;
+#if PG_VERSION_NUM >= 150000
+shmem_request_hook_type    db2SlotPrevShmemRequest = NULL;
+#endif
+shmem_startup_hook_type    db2SlotPrevShmemStartup = NULL;
+
+/** external prototypes */
+extern uint32       db2WaitEventInfo       (db2WaitEvent event);
+
+/** local prototypes */
+void                db2ConnSlotInit        (void);
+void                db2ConnSlotShmemRequest(void);
+void                db2ConnSlotShmemStartup(void);
+int                 db2ConnSlotFind        (const char* dbserver);
+int                 db2ConnSlotAcquire     (const char* dbserver, int wait);
+void                db2ConnSlotRelease     (const char* dbserver);
+void                db2ConnSlotExit        (int code, Datum arg);
+void                db2QuerySlotAcquire    (const char* dbserver, int limit, DB2Metrics* metrics);
+void                db2QuerySlotRelease    (const char* dbserver);
+void                db2QuerySlotReleaseAll (void);
+int                 db2ConnSlotLoad        (const char* dbserver);
+void                db2ServerStats         (FunctionCallInfo fcinfo);
+
+/** db2ConnSlotInit
+ *   Ask for the shared memory that counts DB2 connections per database.
+ *   Without shared_preload_libraries db2_fdw.max_connections has no effect.
+ */
+void db2ConnSlotInit (void) {
+  db2Debug1("> db2ConnSlotInit");
+  if (process_shared_preload_libraries_in_progress) {
+#if PG_VERSION_NUM >= 150000
+    db2SlotPrevShmemRequest = shmem_request_hook;
+    shmem_request_hook      = db2ConnSlotShmemRequest;
+#else
+    db2ConnSlotShmemRequest ();
+#endif
+    db2SlotPrevShmemStartup = shmem_startup_hook;
+    shmem_startup_hook      = db2ConnSlotShmemStartup;
+  }
+  db2Debug1("< db2ConnSlotInit");
+}
+
+/** db2ConnSlotShmemRequest
+ *   Reserve shared memory for the connection slots.
+ */
+void db2ConnSlotShmemRequest (void) {
+#if PG_VERSION_NUM >= 150000
+  if (db2SlotPrevShmemRequest)
+    db2SlotPrevShmemRequest ();
+#endif
+  RequestAddinShmemSpace (MAXALIGN (sizeof (DB2ConnSlots)));
+  RequestNamedLWLockTranche ("db2_fdw connection slots", 1);
+}
+
+/** db2ConnSlotShmemStartup
+ *   Create or attach to the connection slots in shared memory.
+ */
+void db2ConnSlotShmemStartup (void) {
+  bool found;
+
+  if (db2SlotPrevShmemStartup)
+    db2SlotPrevShmemStartup ();
+
+  LWLockAcquire (AddinShmemInitLock, LW_EXCLUSIVE);
+  db2ConnSlots = ShmemInitStruct ("db2_fdw connection slots", sizeof (DB2ConnSlots), &found);
+  if (!found) {
+    memset (db2ConnSlots, 0, sizeof (DB2ConnSlots));
+    db2ConnSlots->lock = &(GetNamedLWLockTranche ("db2_fdw connection slots"))->lock;
+    ConditionVariableInit (&db2ConnSlots->cv);
+    ConditionVariableInit (&db2ConnSlots->qcv);
+  }
+  LWLockRelease (AddinShmemInitLock);
+}
+
+/** db2ConnSlotFind
+ *   Return the slot of a DB2 database, assigning a free one on first use.
+ *   If no slot was ever free, the slot of a database that nobody connects
+ *   to any more (e.g. a dropped or renamed server) is taken over, together
+ *   with its statistics.  Returns -1 if all slots are in use by other
+ *   databases, in which case connections to this database are not counted.
+ *   The caller must hold the lock exclusively.
+ */
+int db2ConnSlotFind (const char* dbserver) {
+  int i;
+  int free_slot = -1;
+  int idle_slot = -1;
+
+  for (i = 0; i < DB2_CONN_SLOTS; ++i) {
+    if (db2ConnSlots->slot[i].dbserver[0] == '\0') {
+      if (free_slot < 0 && db2ConnSlots->slot[i].used == 0)
+        free_slot = i;
+    } else if (strncmp (db2ConnSlots->slot[i].dbserver, dbserver, DB2_CONN_SLOT_NAME_LEN - 1) == 0) {
+      return i;
+    } else if (idle_slot < 0 && db2ConnSlots->slot[i].used == 0 && db2ConnSlots->slot[i].queries == 0) {
+      idle_slot = i;
+    }
+  }
+  if (free_slot < 0 && idle_slot >= 0) {
+    /* this backend's own counts are zero for an idle slot, so nothing refers to it */
+    memset (&db2ConnSlots->slot[idle_slot], 0, sizeof (DB2ConnSlot));
+    free_slot = idle_slot;
+  }
+  if (free_slot >= 0)
+    strlcpy (db2ConnSlots->slot[free_slot].dbserver, dbserver, DB2_CONN_SLOT_NAME_LEN);
+  return free_slot;
+}
+
+/** db2ConnSlotAcquire
+ *   Take a connection slot for "dbserver" before a new DB2 connection is opened.
+ *   If db2_fdw.max_connections connections are already open, return 0 unless
+ *   "wait" is set, in which case sleep until another backend closes one, but
+ *   no longer than db2_fdw.connection_wait_timeout.
+ *   Returns 1 once the connection may be opened.
+ */
+int db2ConnSlotAcquire (const char* dbserver, int wait) {
+  int        idx   = -1;
+  bool       slept = false;
+  instr_time start;
+
+  if (db2ConnSlots == NULL)
+    return 1;
+  db2Debug1("> db2ConnSlotAcquire(dbserver: '%s', wait: %d)", dbserver ? dbserver : "", wait);
+  if (!db2ConnSlotExitSet) {
+    /* shared memory is gone by the time on_proc_exit callbacks run */
+    before_shmem_exit (db2ConnSlotExit, (Datum) 0);
+    db2ConnSlotExitSet = true;
+  }
+  INSTR_TIME_SET_CURRENT (start);
+  for (;;) {
+    LWLockAcquire (db2ConnSlots->lock, LW_EXCLUSIVE);
+    idx = db2ConnSlotFind (dbserver ? dbserver : "");
+    if (idx < 0 || db2MaxConnections <= 0 || db2ConnSlots->slot[idx].used < db2MaxConnections) {
+      if (idx >= 0) {
+        db2ConnSlots->slot[idx].used++;
+        db2ConnSlotHeld[idx]++;
+      }
+      LWLockRelease (db2ConnSlots->lock);
+      break;
+    }
+    LWLockRelease (db2ConnSlots->lock);
+    if (!wait) {
+      db2Debug1("< db2ConnSlotAcquire - returns: 0");
+      return 0;
+    }
+    /* sleeping checks for interrupts, so statement_timeout ends the wait as well */
+#if PG_VERSION_NUM >= 130000
+    if (db2ConnWaitTimeout > 0) {
+      instr_time now;
+      long       remaining;
+
+      INSTR_TIME_SET_CURRENT (now);
+      INSTR_TIME_SUBTRACT (now, start);
+      remaining = db2ConnWaitTimeout - (long) INSTR_TIME_GET_MILLISEC (now);
+      if (remaining <= 0) {
+        if (slept)
+          ConditionVariableCancelSleep ();
+        ereport ( ERROR
+                , ( errcode (ERRCODE_TOO_MANY_CONNECTIONS)
+                  , errmsg ("too many connections to server \"%s\"", dbserver ? dbserver : "")
+                  , errdetail ("db2_fdw.max_connections (%d) connections are open and none was closed within db2_fdw.connection_wait_timeout.", db2MaxConnections)
+                  )
+                );
+      }
+      ConditionVariableTimedSleep (&db2ConnSlots->cv, remaining, db2WaitEventInfo (DB2_WAIT_CONNECT_SLOT));
+    } else
+#endif
+      ConditionVariableSleep (&db2ConnSlots->cv, db2WaitEventInfo (DB2_WAIT_CONNECT_SLOT));
+    slept = true;
+  }
+  if (slept)
+    ConditionVariableCancelSleep ();
+  db2Debug1("< db2ConnSlotAcquire - returns: 1, slot: %d", idx);
+  return 1;
+}
+
+/** db2ConnSlotRelease
+ *   Give back the slot of a DB2 connection that was closed and wake up waiting backends.
+ */
+void db2ConnSlotRelease (const char* dbserver) {
+  int idx = -1;
+
+  if (db2ConnSlots == NULL)
+    return;
+  db2Debug1("> db2ConnSlotRelease(dbserver: '%s')", dbserver ? dbserver : "");
+  LWLockAcquire (db2ConnSlots->lock, LW_EXCLUSIVE);
+  idx = db2ConnSlotFind (dbserver ? dbserver : "");
+  if (idx >= 0 && db2ConnSlotHeld[idx] > 0) {
+    db2ConnSlots->slot[idx].used--;
+    db2ConnSlotHeld[idx]--;
+  }
+  LWLockRelease (db2ConnSlots->lock);
+  ConditionVariableBroadcast (&db2ConnSlots->cv);
+  db2Debug1("< db2ConnSlotRelease");
+}
+
+/** db2ConnSlotExit
+ *   Give back all slots this backend still holds when it exits.
+ *   The DB2 connections themselves are closed later by exitHook.
+ */
+void db2ConnSlotExit (int code, Datum arg) {
+  int i;
+
+  LWLockAcquire (db2ConnSlots->lock, LW_EXCLUSIVE);
+  for (i = 0; i < DB2_CONN_SLOTS; ++i) {
+    db2ConnSlots->slot[i].used -= db2ConnSlotHeld[i];
+    db2ConnSlotHeld[i]          = 0;
+    if (db2QuerySlotHeld[i] > 0)
+      db2ConnSlots->slot[i].queries--;
+    db2QuerySlotHeld[i]         = 0;
+  }
+  LWLockRelease (db2ConnSlots->lock);
+  ConditionVariableBroadcast (&db2ConnSlots->cv);
+  ConditionVariableBroadcast (&db2ConnSlots->qcv);
+  /* exitHook must not touch shared memory any more */
+  db2ConnSlots = NULL;
+}
+
+/** db2QuerySlotAcquire
+ *   Wait until the DB2 database "dbserver" runs remote queries for fewer than
+ *   "limit" backends, then count this backend in.  A backend that already runs
+ *   a query there is admitted at once, so that nested scans cannot wait for
+ *   themselves, and so is one that runs queries on other databases: waiting
+ *   while holding those admissions could deadlock with a backend that holds
+ *   this database and waits for one of them.
+ *   The time spent waiting is added to "metrics", if given.
+ */
+void db2QuerySlotAcquire (const char* dbserver, int limit, DB2Metrics* metrics) {
+  int       idx   = -1;
+  int       i;
+  bool      slept = false;
+  bool      other = false;
+  instr_time start;
+  instr_time duration;
+
+  if (db2ConnSlots == NULL || limit <= 0)
+    return;
+  db2Debug1("> db2QuerySlotAcquire(dbserver: '%s', limit: %d)", dbserver ? dbserver : "", limit);
+  if (!db2ConnSlotExitSet) {
+    before_shmem_exit (db2ConnSlotExit, (Datum) 0);
+    db2ConnSlotExitSet = true;
+  }
+  INSTR_TIME_SET_ZERO (duration);
+  INSTR_TIME_SET_CURRENT (start);
+  for (;;) {
+    LWLockAcquire (db2ConnSlots->lock, LW_EXCLUSIVE);
+    idx = db2ConnSlotFind (dbserver ? dbserver : "");
+    for (i = 0, other = false; idx >= 0 && i < DB2_CONN_SLOTS && !other; ++i)
+      other = (i != idx && db2QuerySlotHeld[i] > 0);
+    if (idx < 0 || db2QuerySlotHeld[idx] > 0 || other || db2ConnSlots->slot[idx].queries < limit) {
+      if (idx >= 0) {
+        if (db2QuerySlotHeld[idx]++ == 0)
+          db2ConnSlots->slot[idx].queries++;
+        db2ConnSlots->slot[idx].admitted++;
+        if (slept) {
+          INSTR_TIME_SET_CURRENT (duration);
+          INSTR_TIME_SUBTRACT (duration, start);
+          db2ConnSlots->slot[idx].queued++;
+          db2ConnSlots->slot[idx].queue_ms += INSTR_TIME_GET_MILLISEC (duration);
+        }
+      }
+      LWLockRelease (db2ConnSlots->lock);
+      break;
+    }
+    LWLockRelease (db2ConnSlots->lock);
+    /* sleeping checks for interrupts, so statement_timeout ends the wait */
+    ConditionVariableSleep (&db2ConnSlots->qcv, db2WaitEventInfo (DB2_WAIT_QUERY_SLOT));
+    slept = true;
+  }
+  if (slept) {
+    ConditionVariableCancelSleep ();
+    if (metrics != NULL) {
+      metrics->queued++;
+      metrics->queue_ms += INSTR_TIME_GET_MILLISEC (duration);
+    }
+  }
+  db2Debug1("< db2QuerySlotAcquire - slot: %d", idx);
+}
+
+/** db2QuerySlotRelease
+ *   A scan admitted by db2QuerySlotAcquire has finished.
+ */
+void db2QuerySlotRelease (const char* dbserver) {
+  int  idx  = -1;
+  bool wake = false;
+
+  if (db2ConnSlots == NULL)
+    return;
+  db2Debug1("> db2QuerySlotRelease(dbserver: '%s')", dbserver ? dbserver : "");
+  LWLockAcquire (db2ConnSlots->lock, LW_EXCLUSIVE);
+  idx = db2ConnSlotFind (dbserver ? dbserver : "");
+  if (idx >= 0 && db2QuerySlotHeld[idx] > 0 && --db2QuerySlotHeld[idx] == 0) {
+    db2ConnSlots->slot[idx].queries--;
+    wake = true;
+  }
+  LWLockRelease (db2ConnSlots->lock);
+  if (wake)
+    ConditionVariableBroadcast (&db2ConnSlots->qcv);
+  db2Debug1("< db2QuerySlotRelease");
+}
+
+/** db2QuerySlotReleaseAll
+ *   Give back all query slots at the end of a transaction,
+ *   including those of scans that ended with an error.
+ */
+void db2QuerySlotReleaseAll (void) {
+  int  i;
+  bool wake = false;
+
+  if (db2ConnSlots == NULL)
+    return;
+  LWLockAcquire (db2ConnSlots->lock, LW_EXCLUSIVE);
+  for (i = 0; i < DB2_CONN_SLOTS; ++i) {
+    if (db2QuerySlotHeld[i] > 0) {
+      db2ConnSlots->slot[i].queries--;
+      db2QuerySlotHeld[i] = 0;
+      wake                = true;
+    }
+  }
+  LWLockRelease (db2ConnSlots->lock);
+  if (wake)
+    ConditionVariableBroadcast (&db2ConnSlots->qcv);
+}
+
+/** db2ConnSlotLoad
+ *   Return the number of sessions running remote queries on "dbserver",
+ *   0 if it has no slot yet, or -1 if db2_fdw was not loaded at server start.
+ */
+int db2ConnSlotLoad (const char* dbserver) {
+  int i;
+  int load = 0;
+
+  if (db2ConnSlots == NULL)
+    return -1;
+  LWLockAcquire (db2ConnSlots->lock, LW_SHARED);
+  for (i = 0; i < DB2_CONN_SLOTS; ++i) {
+    if (strncmp (db2ConnSlots->slot[i].dbserver, dbserver, DB2_CONN_SLOT_NAME_LEN - 1) == 0) {
+      load = db2ConnSlots->slot[i].queries;
+      break;
+    }
+  }
+  LWLockRelease (db2ConnSlots->lock);
+  return load;
+}
+
+/** db2ServerStats
+ *   Return connections, running queries and admission statistics per DB2 database.
+ */
+void db2ServerStats (FunctionCallInfo fcinfo) {
+  ReturnSetInfo*   rsinfo = (ReturnSetInfo*) fcinfo->resultinfo;
+  TupleDesc        tupdesc;
+  Tuplestorestate* tupstore;
+  MemoryContext    oldcontext;
+  DB2ConnSlot      slots[DB2_CONN_SLOTS];
+  int              n;
+
+  db2Debug1("> db2ServerStats");
+  if (db2ConnSlots == NULL)
+    ereport (ERROR, (errcode (ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE), errmsg ("db2_fdw must be loaded via \"shared_preload_libraries\" to track DB2 servers")));
+  if (rsinfo == NULL || !IsA (rsinfo, ReturnSetInfo) || !(rsinfo->allowedModes & SFRM_Materialize))
+    ereport (ERROR, (errcode (ERRCODE_FEATURE_NOT_SUPPORTED), errmsg ("set-valued function called in context that cannot accept a set")));
+  if (get_call_result_type (fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+    elog (ERROR, "return type must be a row type");
+
+  oldcontext         = MemoryContextSwitchTo (rsinfo->econtext->ecxt_per_query_memory);
+  tupstore           = tuplestore_begin_heap (true, false, work_mem);
+  rsinfo->returnMode = SFRM_Materialize;
+  rsinfo->setResult  = tupstore;
+  rsinfo->setDesc    = tupdesc;
+  MemoryContextSwitchTo (oldcontext);
+
+  /* copy the slots so that the lock is not held while the tuples are built */
+  LWLockAcquire (db2ConnSlots->lock, LW_SHARED);
+  memcpy (slots, db2ConnSlots->slot, sizeof (slots));
+  LWLockRelease (db2ConnSlots->lock);
+
+  for (n = 0; n < DB2_CONN_SLOTS; ++n) {
+    Datum values[DB2_SERVER_COLS];
+    bool  nulls[DB2_SERVER_COLS];
+    int   i = 0;
+
+    if (slots[n].dbserver[0] == '\0')
+      continue;
+    memset (nulls, 0, sizeof (nulls));
+    values[i++] = CStringGetTextDatum (slots[n].dbserver);
+    values[i++] = Int32GetDatum (slots[n].used);
+    values[i++] = Int32GetDatum (slots[n].queries);
+    values[i++] = Int64GetDatum (slots[n].admitted);
+    values[i++] = Int64GetDatum (slots[n].queued);
+    values[i++] = Float8GetDatum (slots[n].queue_ms);
+    Assert (i == DB2_SERVER_COLS);
+    tuplestore_putvalues (tupstore, tupdesc, values, nulls);
+  }
+  db2Debug1("< db2ServerStats");
+}
@@ -0,0 +1,71 @@
+#include <postgres.h>
+#include <funcapi.h>
+#include <miscadmin.h>
+#include <utils/builtins.h>
+#include <utils/timestamp.h>
+#include <utils/tuplestore.h>
+#include "db2_fdw.h"
+
+/** number of columns of db2_fdw_connections */
+#define DB2_CONN_COLS 10
+
+/** external prototypes */
+extern int          db2ConnStats         (DB2ConnStat* stats, int max);
+
+/** local prototypes */
+void                db2Connections       (FunctionCallInfo fcinfo);
+
+/** db2Connections
+ *   Return one row per cached DB2 connection of this backend.
+ */
+void db2Connections (FunctionCallInfo fcinfo) {
+  ReturnSetInfo*   rsinfo = (ReturnSetInfo*) fcinfo->resultinfo;
+  TupleDesc        tupdesc;
+  Tuplestorestate* tupstore;
+  MemoryContext    oldcontext;
+  DB2ConnStat*     stats;
+  int              count;
+  int              n;
+
+  db2Debug1("> db2Connections");
+  if (rsinfo == NULL || !IsA (rsinfo, ReturnSetInfo) || !(rsinfo->allowedModes & SFRM_Materialize))
+    ereport (ERROR, (errcode (ERRCODE_FEATURE_NOT_SUPPORTED), errmsg ("set-valued function called in context that cannot accept a set")));
+  if (get_call_result_type (fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+    elog (ERROR, "return type must be a row type");
+
+  oldcontext         = MemoryContextSwitchTo (rsinfo->econtext->ecxt_per_query_memory);
+  tupstore           = tuplestore_begin_heap (true, false, work_mem);
+  rsinfo->returnMode = SFRM_Materialize;
+  rsinfo->setResult  = tupstore;
+  rsinfo->setDesc    = tupdesc;
+  MemoryContextSwitchTo (oldcontext);
+
+  /* count first, then copy the statistics */
+  count = db2ConnStats (NULL, 0);
+  stats = (count > 0) ? palloc (count * sizeof (DB2ConnStat)) : NULL;
+  count = db2ConnStats (stats, count);
+
+  for (n = 0; n < count; ++n) {
+    Datum values[DB2_CONN_COLS];
+    bool  nulls[DB2_CONN_COLS];
+    int   i = 0;
+
+    memset (nulls, 0, sizeof (nulls));
+    values[i++] = CStringGetTextDatum (stats[n].srvname  ? stats[n].srvname  : "");
+    if (stats[n].uid == NULL)
+      nulls[i++]  = true;
+    else
+      values[i++] = CStringGetTextDatum (stats[n].uid);
+    values[i++] = CStringGetTextDatum (stats[n].nls_lang ? stats[n].nls_lang : "");
+    values[i++] = TimestampTzGetDatum (time_t_to_timestamptz (stats[n].connected));
+    values[i++] = TimestampTzGetDatum (time_t_to_timestamptz (stats[n].last_used));
+    values[i++] = Int64GetDatum (stats[n].uses);
+    values[i++] = Int64GetDatum (stats[n].commits);
+    values[i++] = Int64GetDatum (stats[n].rollbacks);
+    values[i++] = Int64GetDatum (stats[n].pings);
+    values[i++] = BoolGetDatum (stats[n].in_xact != 0);
+    Assert (i == DB2_CONN_COLS);
+    tuplestore_putvalues (tupstore, tupdesc, values, nulls);
+  }
+  db2Debug1("< db2Connections");
+}
@@ -9,7 +9,6 @@
 
 /** external prototypes */
 extern void*     db2alloc             (const char* type, size_t size);
-extern void      db2Debug1            (const char* message, ...);
 
 /** local prototypes */
 char*            db2CopyText          (const char* string, int size, int quote);
@@ -5,6 +5,9 @@
 #include <nodes/pathnodes.h>
 #include <optimizer/optimizer.h>
 #include <access/heapam.h>
+#if PG_VERSION_NUM < 140000
+#include <utils/guc.h>
+#endif
 #include "db2_fdw.h"
 
 /* get a PostgreSQL error code from an db2error */
@@ -16,25 +19,41 @@
   (x==FDW_OUT_OF_MEMORY ? ERRCODE_FDW_OUT_OF_MEMORY : \
   (x==FDW_SERIALIZATION_FAILURE ? ERRCODE_T_R_SERIALIZATION_FAILURE : ERRCODE_FDW_ERROR))))))
 
+#if PG_VERSION_NUM < 140000
+/* message_level_is_interesting appeared in PostgreSQL 14; DEBUG levels compare numerically */
+#define message_level_is_interesting(elevel) \
+  ((elevel) >= log_min_messages || (elevel) >= client_min_messages)
+#endif
+
+/** global variables */
+int  db2TraceLevel = 0;                    /* set by the GUC db2_fdw.trace_level, 0 disables tracing        */
+
+/** external variables */
+extern DB2Diag db2Diag;                    /* structured diagnostics of the last failed call, set by db2CheckErr() */
+
 /** local prototype */
 void db2Error  (db2error sqlstate, const char* message);
 void db2Error_d(db2error sqlstate, const char* message, const char* detail, ...) __attribute__ ((format (gnu_printf, 2, 0)));
-void db2Debug1 (const char* message, ...)__attribute__ ((format (gnu_printf, 1, 0)));
-void db2Debug2 (const char* message, ...)__attribute__ ((format (gnu_printf, 1, 0)));
-void db2Debug3 (const char* message, ...)__attribute__ ((format (gnu_printf, 1, 0)));
-void db2Debug4 (const char* message, ...)__attribute__ ((format (gnu_printf, 1, 0)));
-void db2Debug5 (const char* message, ...)__attribute__ ((format (gnu_printf, 1, 0)));
 
 /** db2Error_d
  *    Report a PostgreSQL error with a detail message.
+ *    If the error follows a failed DB2 call, the hint names the DB2 message
+ *    of its first diagnostic record.
  */
 void db2Error_d (db2error sqlstate, const char *message, const char *detail, ...) {
   char    cBuffer [4000];
   va_list arg_marker;
+  DB2Diag diag = db2Diag;
   /* if the backend was terminated, report that rather than the DB2 error */
   CHECK_FOR_INTERRUPTS ();
   va_start(arg_marker, detail);
   vsnprintf(cBuffer, sizeof(cBuffer), detail, arg_marker);
+  /* the diagnostics belong to this error only */
+  db2Diag.nrecs = 0;
+  if (diag.nrecs > 0) {
+    ereport (ERROR, (errcode (to_sqlstate (sqlstate)), errmsg ("%s", message), errdetail ("%s", cBuffer),
+                     errhint ("See DB2 message SQL%04d%c, SQLSTATE %s.", abs (diag.sqlcode), (diag.sqlcode < 0) ? 'N' : 'W', diag.sqlstate)));
+  }
   ereport (ERROR, (errcode (to_sqlstate (sqlstate)), errmsg ("%s", message), errdetail ("%s", cBuffer)));
   va_end  (arg_marker);
 }
@@ -51,58 +70,20 @@ void db2Error (db2error sqlstate, const char *message) {
   }
 }
 
-/** db2Debug1
- *  Rendering a single DEBUG1 output line to the pg log file.
+/** db2Trace
+ *  Rendering a single DEBUG1 .. DEBUG5 output line to the pg log file.
+ *  Callers use the db2Debug1 .. db2Debug5 macros, which check
+ *  db2TraceLevel first; the message is only formatted if PostgreSQL
+ *  would actually emit it.
  */
-void db2Debug1(const char* message, ...) {
-  char cBuffer [4000];
-  va_list arg_marker;
-  va_start (arg_marker, message);
-  vsnprintf (cBuffer, sizeof(cBuffer),  message, arg_marker);
-  elog (DEBUG1, "%s", cBuffer);
-  va_end   (arg_marker);
-}
-/** db2Debug2
- *  Rendering a single DEBUG2 output line to the pg log file.
- */
-void db2Debug2(const char* message, ...) {
-  char cBuffer [4000];
-  va_list arg_marker;
-  va_start (arg_marker, message);
-  vsnprintf (cBuffer, sizeof(cBuffer),  message, arg_marker);
-  elog (DEBUG2, "%s", cBuffer);
-  va_end   (arg_marker);
-}
-/** db2Debug3
- *  Rendering a single DEBUG3 output line to the pg log file.
- */
-void db2Debug3(const char* message, ...) {
-  char cBuffer [4000];
-  va_list arg_marker;
-  va_start (arg_marker, message);
-  vsnprintf (cBuffer, sizeof(cBuffer),  message, arg_marker);
-  elog (DEBUG3, "%s", cBuffer);
-  va_end   (arg_marker);
-}
-/** db2Debug4
- *  Rendering a single DEBUG4 output line to the pg log file.
- */
-void db2Debug4(const char* message, ...) {
-  char cBuffer [4000];
-  va_list arg_marker;
-  va_start (arg_marker, message);
-  vsnprintf (cBuffer, sizeof(cBuffer),  message, arg_marker);
-  elog (DEBUG4, "%s", cBuffer);
-  va_end   (arg_marker);
-}
-/** db2Debug5
- *  Rendering a single DEBUG5 output line to the pg log file.
- */
-void db2Debug5(const char* message, ...) {
-  char cBuffer [4000];
+void db2Trace (int level, const char* message, ...) {
+  static const int elevel[] = { DEBUG1, DEBUG1, DEBUG2, DEBUG3, DEBUG4, DEBUG5 };
+  char    cBuffer [4000];
   va_list arg_marker;
+  if (level < 1 || level > 5 || !message_level_is_interesting (elevel[level]))
+    return;
   va_start (arg_marker, message);
   vsnprintf (cBuffer, sizeof(cBuffer),  message, arg_marker);
-  elog (DEBUG5, "%s", cBuffer);
+  elog (elevel[level], "%s", cBuffer);
   va_end   (arg_marker);
 }
@@ -6,6 +6,7 @@
 #include "db2_fdw.h"
 
 /** global variables */
+int                 db2LobInlineSize = DEFAULT_LOB_INLINE_SIZE; /* LOB columns up to this size are bound with the row, set by db2_fdw.lob_inline_size */
 
 /** external variables */
 extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
@@ -15,14 +16,14 @@ extern int          err_code;              /* error code, set by db2CheckErr()
 extern bool         optionIsTrue         (const char* value);
 extern void*        db2alloc             (const char* type, size_t size);
 extern void         db2free              (void* p);
-extern void         db2Debug1            (const char* message, ...);
-extern void         db2Debug2            (const char* message, ...);
 extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
 extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
 extern char*        db2CopyText          (const char* string, int size, int quote);
 extern char*        c2name               (short fcType);
 extern HdlEntry*    db2AllocStmtHdl      (SQLSMALLINT type, DB2ConnEntry* connp, db2error error, const char* errmsg);
 extern void         db2FreeStmtHdl       (HdlEntry* handlep, DB2ConnEntry* connp);
+extern void         db2WaitStart         (db2WaitEvent event);
+extern void         db2WaitEnd           (void);
 
 /** internal prototypes */
 DB2Table*           db2Describe          (DB2Session* session, char* schema, char* table, char* pgname, long max_long, char* noencerr, char* batchsz);
@@ -50,6 +51,7 @@ DB2Table* db2Describe (DB2Session* session, char* schema, char* table, char* pgn
   SQLSMALLINT scale;
   SQLSMALLINT nullable;
   SQLINTEGER  codepage = 0;
+  SQLINTEGER  clientcp = 0;
   SQLRETURN   rc = 0;
 
   db2Debug1("> db2Describe");
@@ -80,13 +82,17 @@ DB2Table* db2Describe (DB2Session* session, char* schema, char* table, char* pgn
   stmthp = db2AllocStmtHdl(SQL_HANDLE_STMT, session->connp, FDW_UNABLE_TO_CREATE_REPLY, "error describing remote table: failed to allocate statement handle");
 
   /* prepare the query */
+  db2WaitStart (DB2_WAIT_PREPARE);
   rc = SQLPrepare(stmthp->hsql, query, SQL_NTS);
+  db2WaitEnd ();
   rc = db2CheckErr(rc, stmthp->hsql,stmthp->type, __LINE__, __FILE__);
   if (rc != SQL_SUCCESS) {
     db2Error_d (FDW_UNABLE_TO_CREATE_REPLY, "error describing remote table: SQLPrepare failed to prepare query", db2Message);
   }
   /* execute the query */
+  db2WaitStart (DB2_WAIT_EXECUTE);
   rc = SQLExecute(stmthp->hsql);
+  db2WaitEnd ();
   rc= db2CheckErr(rc, stmthp->hsql, stmthp->type, __LINE__, __FILE__);
   if (rc != SQL_SUCCESS) {
     if (err_code == 942)
@@ -124,6 +130,15 @@ DB2Table* db2Describe (DB2Session* session, char* schema, char* table, char* pgn
   reply->cols = (DB2Column **) db2alloc ("reply->cols", sizeof (DB2Column *) * reply->ncols);
   db2Debug2("  reply->ncols  : %d", reply->ncols);
 
+  /* get the application codepage that DB2 converts character data to */
+  rc = SQLGetConnectAttr(session->connp->hdbc, SQL_ATTR_CLIENT_CODEPAGE, &clientcp, 0, NULL);
+  rc = db2CheckErr(rc, session->connp->hdbc, SQL_HANDLE_DBC, __LINE__, __FILE__);
+  if (rc != SQL_SUCCESS) {
+    /* unknown, all character data will be validated */
+    clientcp = 0;
+  }
+  db2Debug2("  client codepage: %d", clientcp);
+
   /* loop through the column list */
   for (i = 1; i <= reply->ncols; ++i) {
     /* allocate an db2Column struct for the column */
@@ -140,6 +155,8 @@ DB2Table* db2Describe (DB2Session* session, char* schema, char* table, char* pgn
     reply->cols[i - 1]->val_len        = 0;
     reply->cols[i - 1]->val_null       = 1;
     reply->cols[i - 1]->noencerr       = NO_ENC_ERR_NULL;
+    reply->cols[i - 1]->lobInline      = 0;
+    reply->cols[i - 1]->convUtf8       = 0;
 
     if (noencerr != NULL) {
       reply->cols[i - 1]->noencerr = (optionIsTrue(noencerr)) ? NO_ENC_ERR_TRUE : NO_ENC_ERR_FALSE;
@@ -202,6 +219,8 @@ DB2Table* db2Describe (DB2Session* session, char* schema, char* table, char* pgn
     }
     reply->cols[i - 1]->colCodepage = (int) codepage;
     db2Debug2("  reply->cols[%d]->colCodepage : %d", (i-1), reply->cols[i - 1]->colCodepage);
+    /* data converted from a non-Unicode codepage to UTF-8 are always valid UTF-8 */
+    reply->cols[i - 1]->convUtf8 = (clientcp == 1208 && codepage != 0 && codepage != 1208 && codepage != 1200) ? 1 : 0;
 
     /* Unfortunately a LONG VARBINARY is of type LONG VARCHAR but the codepage is set to 0 */
     if (reply->cols[i-1]->colType == SQL_LONGVARCHAR && reply->cols[i-1]->colCodepage == 0){
@@ -218,6 +237,12 @@ DB2Table* db2Describe (DB2Session* session, char* schema, char* table, char* pgn
       case SQL_BLOB:
       case SQL_CLOB:
         reply->cols[i - 1]->val_size = bin_size + 1;
+        /* small LOBs are fetched with the row, larger ones via locator and SQLGetData;
+         * a CLOB converted to another codepage may grow beyond its octet length, so it is never inline
+         */
+        reply->cols[i - 1]->lobInline = (bin_size <= db2LobInlineSize
+                                      && (reply->cols[i - 1]->colType == SQL_BLOB || codepage == 0 || codepage == clientcp)) ? 1 : 0;
+        db2Debug2("  reply->cols[%d]->lobInline: %d", (i-1), reply->cols[i - 1]->lobInline);
       break;
       case SQL_GRAPHIC:
       case SQL_VARGRAPHIC:
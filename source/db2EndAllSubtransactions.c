@@ -0,0 +1,26 @@
+#include <sqlcli1.h>
+#include <postgres_ext.h>
+#include "db2_fdw.h"
+
+/** external variables */
+extern DB2EnvEntry* rootenvEntry;          /* Linked list of handles for cached DB2 connections.            */
+
+/** external prototypes */
+extern void         db2EndSubtransaction (void* arg, int nest_level, int is_commit);
+
+/** local prototypes */
+void                db2EndAllSubtransactions(int nest_level, int is_commit);
+
+/** db2EndAllSubtransactions
+ *   Commit or rollback subtransaction "nest_level" on all cached connections.
+ */
+void db2EndAllSubtransactions (int nest_level, int is_commit) {
+  DB2EnvEntry*  envp  = NULL;
+  DB2ConnEntry* connp = NULL;
+
+  db2Debug1("> db2EndAllSubtransactions(nest_level:%d, is_commit:%d)",nest_level,is_commit);
+  for (envp = rootenvEntry; envp != NULL; envp = envp->right)
+    for (connp = envp->connlist; connp != NULL; connp = connp->right)
+      db2EndSubtransaction (connp, nest_level, is_commit);
+  db2Debug1("< db2EndAllSubtransactions");
+}
@@ -0,0 +1,141 @@
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <sqlcli1.h>
+#include <postgres_ext.h>
+#include "db2_fdw.h"
+
+/** DB2EndTran
+ *  One SQLEndTran call handed to a helper thread.
+ *  The thread only calls DB2 CLI, all checks are done afterwards by the backend.
+ */
+typedef struct db2EndTran {
+  DB2ConnEntry*       connp;                  // connection whose unit of work is ended
+  SQLSMALLINT         completion;             // SQL_COMMIT or SQL_ROLLBACK
+  SQLRETURN           rc;                     // result of SQLEndTran
+  pthread_t           thread;                 // helper thread
+  int                 started;                // 1 = "thread" runs the call, 0 = not yet called
+} DB2EndTran;
+
+/** external variables */
+extern DB2EnvEntry* rootenvEntry;          /* Linked list of handles for cached DB2 connections.            */
+extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
+
+/** external prototypes */
+extern void*        db2alloc             (const char* type, size_t size);
+extern void         db2free              (void* p);
+extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
+extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
+extern void         db2FreeStmtHdl       (HdlEntry* handlep, DB2ConnEntry* connp);
+extern void         db2EndTransaction    (void* arg, int is_commit, int noerror);
+extern void         db2Autocommit        (DB2ConnEntry* connp, int noerror);
+extern void         db2WaitStart         (db2WaitEvent event);
+extern void         db2WaitEnd           (void);
+extern int          db2StartThread       (void* (*body) (void*), void* arg, pthread_t* thread);
+
+/** local prototypes */
+void                db2EndAllTransactions(int is_commit, int noerror, int parallel);
+void*               db2EndTranThread     (void* arg);
+
+/** db2EndAllTransactions
+ *   Commit or rollback the remote transactions of all cached connections.
+ *   If "parallel" is set and more than one connection modified data, the
+ *   SQLEndTran calls run concurrently in helper threads, so that the
+ *   transaction waits for the slowest server instead of the sum of all.
+ *   If "noerror" is true, don't throw errors; otherwise the first failure
+ *   is reported once every connection has been dealt with.
+ */
+void db2EndAllTransactions (int is_commit, int noerror, int parallel) {
+  DB2EnvEntry*  envp    = NULL;
+  DB2ConnEntry* connp   = NULL;
+  DB2EndTran*   trans   = NULL;
+  int           ndirty  = 0;
+  int           i       = 0;
+  int           failed  = 0;
+  char          message[ERRBUFSIZE];
+
+  db2Debug1("> db2EndAllTransactions(is_commit:%d, noerror:%d, parallel:%d)",is_commit,noerror,parallel);
+  for (envp = rootenvEntry; envp != NULL; envp = envp->right)
+    for (connp = envp->connlist; connp != NULL; connp = connp->right)
+      if (connp->xact_level > 0 && connp->xact_dirty)
+        ++ndirty;
+
+  if (!parallel || ndirty < 2) {
+    for (envp = rootenvEntry; envp != NULL; envp = envp->right)
+      for (connp = envp->connlist; connp != NULL; connp = connp->right)
+        db2EndTransaction (connp, is_commit, noerror);
+    db2Debug1("< db2EndAllTransactions");
+    return;
+  }
+
+  /* release the statement handles and collect the connections that must be ended */
+  trans = db2alloc ("trans", ndirty * sizeof (DB2EndTran));
+  for (envp = rootenvEntry; envp != NULL; envp = envp->right) {
+    for (connp = envp->connlist; connp != NULL; connp = connp->right) {
+      if (connp->xact_level <= 0)
+        continue;
+      while (connp->handlelist != NULL)
+        db2FreeStmtHdl(connp->handlelist, connp);
+      if (connp->xact_dirty) {
+        trans[i].connp      = connp;
+        trans[i].completion = is_commit ? SQL_COMMIT : SQL_ROLLBACK;
+        ++i;
+      } else {
+        connp->xact_level = 0;
+        connp->last_used  = time(NULL);
+      }
+    }
+  }
+
+  for (i = 1; i < ndirty; ++i)
+    trans[i].started = (db2StartThread (db2EndTranThread, &trans[i], &trans[i].thread) == 0);
+
+  /* the backend ends the first unit of work itself and any the threads could not take */
+  db2Debug2("  db2_fdw::db2EndAllTransactions: %s %d remote transactions in parallel", is_commit ? "commit" : "roll back", ndirty);
+  db2WaitStart (DB2_WAIT_COMMIT);
+  for (i = 0; i < ndirty; ++i) {
+    if (!trans[i].started)
+      db2EndTranThread (&trans[i]);
+  }
+  for (i = 1; i < ndirty; ++i) {
+    if (trans[i].started)
+      pthread_join (trans[i].thread, NULL);
+  }
+  db2WaitEnd ();
+
+  for (i = 0; i < ndirty; ++i) {
+    connp = trans[i].connp;
+    trans[i].rc = db2CheckErr(trans[i].rc, connp->hdbc, SQL_HANDLE_DBC, __LINE__, __FILE__);
+    if (trans[i].rc != SQL_SUCCESS && !failed) {
+      /* keep the diagnostics of the first failure */
+      failed = 1;
+      strncpy (message, db2Message, ERRBUFSIZE - 1);
+      message[ERRBUFSIZE - 1] = '\0';
+    }
+    if (is_commit)
+      connp->commits++;
+    else
+      connp->rollbacks++;
+    db2Autocommit (connp, 1);
+    connp->xact_level = 0;
+    connp->last_used  = time(NULL);
+  }
+  db2free (trans);
+  if (failed && !noerror) {
+    if (is_commit)
+      db2Error_d (FDW_UNABLE_TO_CREATE_EXECUTION, "error committing transaction: SQLEndTran failed", message);
+    else
+      db2Error_d (FDW_UNABLE_TO_CREATE_EXECUTION, "error rolling back transaction: SQLEndTran failed", message);
+  }
+  db2Debug1("< db2EndAllTransactions");
+}
+
+/** db2EndTranThread
+ *   End one unit of work; runs in a helper thread (see db2StartThread) or in the backend itself.
+ */
+void* db2EndTranThread (void* arg) {
+  DB2EndTran* tran = (DB2EndTran*) arg;
+
+  tran->rc = SQLEndTran(SQL_HANDLE_DBC, tran->connp->hdbc, tran->completion);
+  return NULL;
+}
@@ -1,10 +1,10 @@
 #include <postgres.h>
 #include <nodes/makefuncs.h>
+#include "db2_fdw.h"
 
 /** external variables */
 
 /** external prototypes */
-extern void         db2Debug1                (const char* message, ...);
 extern void         db2EndForeignModifyCommon(EState *estate, ResultRelInfo *rinfo);
 
 /** local prototypes */
@@ -1,11 +1,11 @@
 #include <postgres.h>
 #include <nodes/makefuncs.h>
+#include "db2_fdw.h"
 
 /** external variables */
 
 /** external prototypes */
 extern void         db2EndForeignModifyCommon(EState *estate, ResultRelInfo *rinfo);
-extern void         db2Debug1                (const char* message, ...);
 
 /** local prototypes */
 void                db2EndForeignModify      (EState* estate, ResultRelInfo* rinfo);
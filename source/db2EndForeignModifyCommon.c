@@ -12,8 +12,8 @@ extern regproc* output_funcs;
 /** external prototypes */
 extern void         db2CloseStatement    (DB2Session* session);
 extern void         db2free              (void* p);
-extern void         db2Debug1            (const char* message, ...);
-extern void         db2Debug2            (const char* message, ...);
+extern void         db2StatStore         (const char* query, DB2Metrics* metrics, bool error);
+extern void         db2FinishInsert      (DB2FdwState* fdw_state);
 
 /** local prototypes */
 void                db2EndForeignModifyCommon(EState *estate, ResultRelInfo *rinfo);
@@ -30,9 +30,12 @@ void db2EndForeignModifyCommon(EState *estate, ResultRelInfo *rinfo) {
     return;
   }
 
-  /* If you’re batching for COPY, flush any remaining rows here */
-  if (fdw_state->session && fdw_state->db2Table) {
-        /* e.g. db2FlushBatch(fdw_state->session, fdw_state->db2Table); */
+  /* check the last INSERT if it still executes in the background */
+  db2FinishInsert (fdw_state);
+
+  /* add the figures of this modification to db2_fdw_stat_statements */
+  if (fdw_state->metrics != NULL) {
+    db2StatStore (fdw_state->query, fdw_state->metrics, false);
   }
 
   /* Finish statement / cursor, if you keep a handle there */
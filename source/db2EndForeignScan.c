@@ -9,7 +9,8 @@
 /** external prototypes */
 extern void            db2CloseStatement         (DB2Session* session);
 extern void            db2free                   (void* p);
-extern void            db2Debug1                 (const char* message, ...);
+extern void            db2StatStore              (const char* query, DB2Metrics* metrics, bool error);
+extern void            db2QuerySlotRelease       (const char* dbserver);
 
 /** local prototypes */
 void db2EndForeignScan(ForeignScanState* node);
@@ -21,8 +22,21 @@ void db2EndForeignScan (ForeignScanState* node) {
   DB2FdwState* fdw_state = (DB2FdwState*) node->fdw_state;
 
   db2Debug1("> db2EndForeignScan");
+  db2Debug2("  rows: %lu, peak row memory: %zu bytes", fdw_state->rowcount, fdw_state->peak_mem);
+  if (fdw_state->temp_cxt != NULL) {
+    MemoryContextDelete (fdw_state->temp_cxt);
+    fdw_state->temp_cxt = NULL;
+  }
+  /* add the figures of this scan to db2_fdw_stat_statements */
+  if (fdw_state->metrics != NULL) {
+    db2StatStore (fdw_state->query, fdw_state->metrics, false);
+  }
   /* release the DB2 session */
   db2CloseStatement(fdw_state->session);
+  if (fdw_state->admitted) {
+    db2QuerySlotRelease (fdw_state->dbserver);
+    fdw_state->admitted = 0;
+  }
   // check fdw_state->session for dangling references that need to be freed
   db2free(fdw_state->session);
   fdw_state->session = NULL;
@@ -2,11 +2,11 @@
 
 #if PG_VERSION_NUM >= 140000
 #include <nodes/makefuncs.h>
+#include "db2_fdw.h"
 
 /** external variables */
 
 /** external prototypes */
-extern void            db2Debug1                 (const char* message, ...);
 extern TupleTableSlot* db2ExecForeignInsert      (EState* estate, ResultRelInfo* rinfo, TupleTableSlot* slot, TupleTableSlot* planSlot);
 
 /** local prototypes */
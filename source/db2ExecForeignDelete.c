@@ -3,6 +3,12 @@
 #include <nodes/pathnodes.h>
 #include <optimizer/optimizer.h>
 #include <access/heapam.h>
+#include <access/xact.h>
+#if PG_VERSION_NUM >= 130000
+#include <access/detoast.h>
+#else
+#include <access/tuptoaster.h>
+#endif
 #include "db2_fdw.h"
 #include "DB2FdwState.h"
 
@@ -12,12 +18,11 @@ extern regproc* output_funcs;
 
 /** external prototypes */
 extern int             db2ExecuteQuery           (DB2Session* session, const DB2Table* db2Table, ParamDesc* paramList);
-extern void            db2Debug1                 (const char* message, ...);
-extern void            db2Debug2                 (const char* message, ...);
+extern void            db2SetSavepoint           (DB2Session* session, int nest_level);
 extern void            convertTuple              (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trunc_lob) ;
 extern char*           deparseDate               (Datum datum);
 extern char*           deparseTimestamp          (Datum datum, bool hasTimezone);
-extern void*           db2alloc                  (const char* type, size_t size);
+extern bool            setNativeParameter        (ParamDesc* param, Datum datum, Oid pgtype, short colType);
 
 /** local prototypes */
 TupleTableSlot* db2ExecForeignDelete (EState* estate, ResultRelInfo* rinfo, TupleTableSlot* slot, TupleTableSlot* planSlot);
@@ -38,6 +43,9 @@ TupleTableSlot* db2ExecForeignDelete (EState* estate, ResultRelInfo* rinfo, Tupl
   ++fdw_state->rowcount;
   dml_in_transaction = true;
 
+  /* DB2 data are about to be modified, so set the pending savepoints */
+  db2SetSavepoint (fdw_state->session, GetCurrentTransactionNestLevel ());
+
   MemoryContextReset (fdw_state->temp_cxt);
   oldcontext = MemoryContextSwitchTo (fdw_state->temp_cxt);
 
@@ -78,7 +86,6 @@ void setModifyParameters (ParamDesc *paramList, TupleTableSlot * newslot, TupleT
   ParamDesc *param;
   Datum datum;
   bool isnull;
-  int32 value_len;
   char *p, *q;
   Oid pgtype;
   db2Debug1("> setModifyParameters");
@@ -102,6 +109,7 @@ void setModifyParameters (ParamDesc *paramList, TupleTableSlot * newslot, TupleT
       datum = slot_getattr (newslot, db2Table->cols[param->colnum]->pgattnum, &isnull);
     }
 
+    param->native = NATIVE_NONE;
     switch (param->bindType) {
       case BIND_STRING:
       case BIND_NUMBER:
@@ -111,6 +119,10 @@ void setModifyParameters (ParamDesc *paramList, TupleTableSlot * newslot, TupleT
         }
         pgtype = db2Table->cols[param->colnum]->pgtype;
         db2Debug2("  db2Table->cols[%d]->pgtype: %d",param->colnum,db2Table->cols[param->colnum]->pgtype);
+        /* integers and floating point values are bound in binary form */
+        if (param->bindType == BIND_NUMBER && setNativeParameter (param, datum, pgtype, db2Table->cols[param->colnum]->colType)) {
+          break;      /* from switch (param->bindType) */
+        }
         /* special treatment for date, timestamps and intervals */
         if (pgtype == DATEOID) {
           param->value = deparseDate (datum);
@@ -152,17 +164,29 @@ void setModifyParameters (ParamDesc *paramList, TupleTableSlot * newslot, TupleT
           param->value = NULL;
           break;
         }
-        /* detoast it if necessary */
-        datum = (Datum) PG_DETOAST_DATUM (datum);
-        /* the first 4 bytes contain the length */
-        value_len = VARSIZE (datum) - VARHDRSZ;
-        param->value = db2alloc("param->value", value_len);
-        memcpy (param->value, VARDATA(datum), value_len);
+        /*
+         * The value is streamed to DB2 with SQLPutData, reading a value
+         * that is still in the TOAST table one slice at a time.
+         * Compressed values cannot be sliced cheaply, decompress them once.
+         */
+        if (VARATT_IS_EXTERNAL_ONDISK (DatumGetPointer (datum))) {
+          struct varatt_external toast_pointer;
+          VARATT_EXTERNAL_GET_POINTER (toast_pointer, DatumGetPointer (datum));
+          if (VARATT_EXTERNAL_IS_COMPRESSED (toast_pointer)) {
+            datum = (Datum) PG_DETOAST_DATUM (datum);
+          }
+        } else {
+          datum = (Datum) PG_DETOAST_DATUM (datum);
+        }
+        param->value     = (char*) DatumGetPointer (datum);
+        param->value_len = (long) (toast_raw_datum_size (datum) - VARHDRSZ);
       break;
       case BIND_OUTPUT:
       break;
     }
-    db2Debug2("  param->value   : '%s'",param->value);
+    if (param->native == NATIVE_NONE && param->bindType != BIND_LONG && param->bindType != BIND_LONGRAW) {
+      db2Debug2("  param->value   : '%s'",param->value);
+    }
   }
   db2Debug1("< setModifyParameters");
 }
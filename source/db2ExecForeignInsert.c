@@ -4,6 +4,7 @@
 #include <nodes/pathnodes.h>
 #include <optimizer/optimizer.h>
 #include <access/heapam.h>
+#include <access/xact.h>
 #include "db2_fdw.h"
 #include "DB2FdwState.h"
 
@@ -12,12 +13,19 @@ extern bool dml_in_transaction;
 
 /** external prototypes */
 extern int             db2ExecuteInsert          (DB2Session* session, const DB2Table* db2Table, ParamDesc* paramList);
-extern void            db2Debug1                 (const char* message, ...);
+extern int             db2ExecuteInsertAsync     (DB2Session* session, const DB2Table* db2Table, ParamDesc* paramList, unsigned long iteration);
+extern int             db2ExecuteWait            (DB2Session* session, unsigned long* iteration);
+extern void            db2SetSavepoint           (DB2Session* session, int nest_level);
 extern void            setModifyParameters       (ParamDesc* paramList, TupleTableSlot* newslot, TupleTableSlot* oldslot, DB2Table* db2Table, DB2Session* session);
 extern void            convertTuple              (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trunc_lob) ;
 
+/** global variables */
+bool                   db2AsyncDml = false;      /* set by db2_fdw.async_dml */
+
 /** local prototypes */
 TupleTableSlot* db2ExecForeignInsert(EState* estate, ResultRelInfo* rinfo, TupleTableSlot* slot, TupleTableSlot* planSlot);
+bool            db2InsertAsyncOk    (DB2FdwState* fdw_state);
+void            db2FinishInsert     (DB2FdwState* fdw_state);
 
 /** db2ExecForeignInsert
  *   Set the parameter values from the slots and execute the INSERT statement.
@@ -31,15 +39,29 @@ TupleTableSlot* db2ExecForeignInsert (EState* estate, ResultRelInfo* rinfo, Tupl
   db2Debug1("> db2ExecForeignInsert");
   elog (DEBUG2, "  relid: %d", RelationGetRelid (rinfo->ri_RelationDesc));
 
+  /* the previous row may still be executing and owns the parameters */
+  db2FinishInsert (fdw_state);
+
   ++fdw_state->rowcount;
   dml_in_transaction = true;
 
+  /* DB2 data are about to be modified, so set the pending savepoints */
+  db2SetSavepoint (fdw_state->session, GetCurrentTransactionNestLevel ());
+
   MemoryContextReset (fdw_state->temp_cxt);
   oldcontext = MemoryContextSwitchTo (fdw_state->temp_cxt);
 
   /* extract the values from the slot and store them in the parameters */
   setModifyParameters (fdw_state->paramList, slot, planSlot, fdw_state->db2Table, fdw_state->session);
 
+  /* let DB2 insert the row while the executor produces the next one; it is checked on the next call */
+  if (db2AsyncDml && db2InsertAsyncOk (fdw_state)
+  &&  db2ExecuteInsertAsync (fdw_state->session, fdw_state->db2Table, fdw_state->paramList, fdw_state->rowcount)) {
+    MemoryContextSwitchTo (oldcontext);
+    db2Debug1("< db2ExecForeignInsert - executing asynchronously");
+    return slot;
+  }
+
   /* execute the INSERT statement and store RETURNING values in db2Table's columns */
   rows = db2ExecuteInsert (fdw_state->session, fdw_state->db2Table, fdw_state->paramList);
 
@@ -60,3 +82,38 @@ TupleTableSlot* db2ExecForeignInsert (EState* estate, ResultRelInfo* rinfo, Tupl
   db2Debug1("< db2ExecForeignInsert");
   return slot;
 }
+
+/** db2InsertAsyncOk
+ *   An INSERT can be executed in the background unless it has a RETURNING
+ *   clause, whose values are needed right away, or LOB parameters, which
+ *   are streamed by the backend during the execution.
+ */
+bool db2InsertAsyncOk (DB2FdwState* fdw_state) {
+  ParamDesc* param;
+  int        i;
+
+  for (i = 0; i < fdw_state->db2Table->ncols; ++i) {
+    if (fdw_state->db2Table->cols[i]->used)
+      return false;
+  }
+  for (param = fdw_state->paramList; param != NULL; param = param->next) {
+    if (param->bindType == BIND_LONG || param->bindType == BIND_LONGRAW)
+      return false;
+  }
+  return true;
+}
+
+/** db2FinishInsert
+ *   Wait for the INSERT executing in the background, if there is one,
+ *   and check that it added exactly one row.
+ */
+void db2FinishInsert (DB2FdwState* fdw_state) {
+  unsigned long iteration = 0;
+  int           rows;
+
+  if (fdw_state->session == NULL)
+    return;
+  rows = db2ExecuteWait (fdw_state->session, &iteration);
+  if (rows >= 0 && rows != 1)
+    ereport (ERROR, (errcode (ERRCODE_FDW_UNABLE_TO_CREATE_EXECUTION), errmsg ("INSERT on DB2 table added %d rows instead of one in iteration %lu", rows, iteration)));
+}
@@ -9,11 +9,8 @@
 
 /** external prototypes */
 extern DB2FdwState* db2GetFdwState       (Oid foreigntableid, double* sample_percent, bool drescribe);
-extern DB2Session*  db2GetSession        (const char* connectstring, char* user, char* password, char* jwt_token, const char* nls_lang, int curlevel);
+extern DB2Session*  db2GetSession        (const char* connectstring, char* user, char* password, char* jwt_token, const char* nls_lang);
 extern void         db2PrepareQuery      (DB2Session* session, const char* query, DB2Table* db2Table, unsigned long prefetch);
-extern void         db2Debug1            (const char* message, ...);
-extern void         db2Debug2            (const char* message, ...);
-extern void         db2Debug3            (const char* message, ...);
 extern int          db2ExecuteTruncate   (DB2Session* session, const char* query);
 extern void         db2CloseStatement    (DB2Session* session);
 extern void         db2free              (void* p);
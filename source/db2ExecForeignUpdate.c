@@ -4,6 +4,7 @@
 #include <nodes/pathnodes.h>
 #include <optimizer/optimizer.h>
 #include <access/heapam.h>
+#include <access/xact.h>
 #include "db2_fdw.h"
 #include "DB2FdwState.h"
 
@@ -12,8 +13,7 @@ extern bool dml_in_transaction;
 
 /** external prototypes */
 extern int             db2ExecuteQuery           (DB2Session* session, const DB2Table* db2Table, ParamDesc* paramList);
-extern void            db2Debug1                 (const char* message, ...);
-extern void            db2Debug2                 (const char* message, ...);
+extern void            db2SetSavepoint           (DB2Session* session, int nest_level);
 extern void            setModifyParameters       (ParamDesc* paramList, TupleTableSlot* newslot, TupleTableSlot* oldslot, DB2Table* db2Table, DB2Session* session);
 extern void            convertTuple              (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trunc_lob) ;
 
@@ -35,6 +35,9 @@ TupleTableSlot* db2ExecForeignUpdate (EState* estate, ResultRelInfo* rinfo, Tupl
   ++fdw_state->rowcount;
   dml_in_transaction = true;
 
+  /* DB2 data are about to be modified, so set the pending savepoints */
+  db2SetSavepoint (fdw_state->session, GetCurrentTransactionNestLevel ());
+
   MemoryContextReset (fdw_state->temp_cxt);
   oldcontext = MemoryContextSwitchTo (fdw_state->temp_cxt);
 
@@ -0,0 +1,237 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <sqlcli1.h>
+#include <postgres_ext.h>
+#include "db2_fdw.h"
+#include "ParamDesc.h"
+
+/** external variables */
+extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
+extern int          err_code;              /* error code, set by db2CheckErr()                              */
+
+/** external prototypes */
+extern void*        db2alloc             (const char* type, size_t size);
+extern void         db2free              (void* p);
+extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
+extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
+extern void         db2BindParameter     (DB2Session* session, const DB2Table* db2Table, ParamDesc* param, SQLLEN* indicators, int param_count, int col_num);
+extern double       db2MetricsNow        (void);
+extern void         db2WaitStart         (db2WaitEvent event);
+extern void         db2WaitEnd           (void);
+extern int          db2StartThread       (void* (*body) (void*), void* arg, pthread_t* thread);
+
+/** local prototypes */
+int                 db2ExecuteInsertAsync(DB2Session* session, const DB2Table* db2Table, ParamDesc* paramList, unsigned long iteration);
+int                 db2ExecuteWait       (DB2Session* session, unsigned long* iteration);
+void                db2ExecuteAsyncStop  (HdlEntry* handlep);
+void                db2ExecuteAsyncSync  (HdlEntry* handlep);
+void                db2ExecuteAsyncAbort (HdlEntry* handlep);
+void*               db2ExecuteThread     (void* arg);
+
+/** db2ExecuteInsertAsync
+ *   Bind the parameters of one row and hand the execution of the prepared
+ *   INSERT to the helper thread of the statement, starting it on first use.
+ *   Returns 1 at once, or 0 if no thread could be started; the caller then
+ *   executes the statement with db2ExecuteInsert.
+ *   The previous execution must have been checked with db2ExecuteWait, and
+ *   the parameters must not be read by DB2 at execution (no LOBs).
+ */
+int db2ExecuteInsertAsync (DB2Session* session, const DB2Table* db2Table, ParamDesc* paramList, unsigned long iteration) {
+  DB2AsyncExec* async       = session->stmtp->async;
+  SQLLEN*       indicators  = NULL;
+  ParamDesc*    param       = NULL;
+  int           param_count = 0;
+  int           rc          = 0;
+
+  db2Debug1("> db2ExecuteInsertAsync(iteration: %lu)", iteration);
+  if (async == NULL) {
+    if ((async = calloc (1, sizeof (DB2AsyncExec))) == NULL) {
+      db2Debug1("< db2ExecuteInsertAsync - out of memory");
+      return 0;
+    }
+    async->hsql = session->stmtp->hsql;
+    pthread_mutex_init (&async->mutex, NULL);
+    pthread_cond_init (&async->cond, NULL);
+    rc = db2StartThread (db2ExecuteThread, async, &async->thread);
+    if (rc != 0) {
+      pthread_cond_destroy (&async->cond);
+      pthread_mutex_destroy (&async->mutex);
+      free (async);
+      db2Debug1("< db2ExecuteInsertAsync - pthread_create failed: %d", rc);
+      return 0;
+    }
+    session->stmtp->async = async;
+  }
+
+  /* bind the parameters, the indicators must live until the execution is checked */
+  for (param = paramList; param != NULL; param = param->next) {
+    ++param_count;
+  }
+  indicators  = db2alloc ("indicators", param_count * sizeof (SQLLEN));
+  param_count = 0;
+  for (param = paramList; param; param = param->next) {
+    ++param_count;
+    /** colnum in param and param_count are 0 based, but in isrt statements need to be 1 based */
+    db2BindParameter(session, db2Table, param, &indicators[param_count], param_count, param->colnum+1);
+  }
+
+  pthread_mutex_lock (&async->mutex);
+  async->indicators = indicators;
+  async->iteration  = iteration;
+  async->done       = 0;
+  async->pending    = 1;
+  pthread_cond_broadcast (&async->cond);
+  pthread_mutex_unlock (&async->mutex);
+  if (session->metrics != NULL)
+    ++session->metrics->executions;
+  db2Debug1("< db2ExecuteInsertAsync - returns: 1");
+  return 1;
+}
+
+/** db2ExecuteWait
+ *   Wait for the execution handed to the helper thread and check its result.
+ *   Errors are raised with the number of the row that caused them.
+ *   Returns the count of processed rows and sets *iteration to the number
+ *   of the row, or returns -1 if no execution is pending.
+ */
+int db2ExecuteWait (DB2Session* session, unsigned long* iteration) {
+  DB2AsyncExec* async = (session->stmtp != NULL) ? session->stmtp->async : NULL;
+  SQLRETURN     rc    = 0;
+
+  if (async == NULL || !async->pending)
+    return -1;
+  db2Debug1("> db2ExecuteWait");
+  pthread_mutex_lock (&async->mutex);
+  if (!async->done) {
+    /* a cancel request arriving now cancels the execution in the thread */
+    db2WaitStart (DB2_WAIT_EXECUTE);
+    while (!async->done)
+      pthread_cond_wait (&async->cond, &async->mutex);
+    db2WaitEnd ();
+  }
+  async->pending = 0;
+  pthread_mutex_unlock (&async->mutex);
+
+  if (session->metrics != NULL)
+    session->metrics->execute_ms += async->exec_ms;
+  db2free (async->indicators);
+  async->indicators = NULL;
+  *iteration = async->iteration;
+
+  rc = db2CheckErr(async->rc, async->hsql, SQL_HANDLE_STMT, __LINE__, __FILE__);
+  if (rc != SQL_SUCCESS && rc != SQL_NO_DATA) {
+    /* use the correct SQLSTATE for serialization failures */
+    db2Error_d(err_code == 8177 ? FDW_SERIALIZATION_FAILURE : FDW_UNABLE_TO_CREATE_EXECUTION, "error executing query: SQLExecute failed to execute remote query", "row %lu: %s", async->iteration, db2Message);
+  }
+  if (rc == SQL_NO_DATA) {
+    db2Debug1("< db2ExecuteWait - returns: 0");
+    return 0;
+  }
+  db2Debug1("< db2ExecuteWait - returns: %d", (int) async->rowcount);
+  return (int) async->rowcount;
+}
+
+/** db2ExecuteAsyncStop
+ *   End the helper thread of a statement handle that is about to be freed.
+ *   An execution still in progress is cancelled; its result is never
+ *   looked at, which only happens if the modification was aborted.
+ */
+void db2ExecuteAsyncStop (HdlEntry* handlep) {
+  DB2AsyncExec* async = handlep->async;
+  int           busy  = 0;
+
+  if (async == NULL)
+    return;
+  db2Debug1("> db2ExecuteAsyncStop");
+  pthread_mutex_lock (&async->mutex);
+  async->stop = 1;
+  busy        = async->pending && !async->done;
+  pthread_cond_broadcast (&async->cond);
+  pthread_mutex_unlock (&async->mutex);
+  if (busy)
+    SQLCancel (async->hsql);
+  pthread_join (async->thread, NULL);
+  pthread_cond_destroy (&async->cond);
+  pthread_mutex_destroy (&async->mutex);
+  free (async);
+  handlep->async = NULL;
+  db2Debug1("< db2ExecuteAsyncStop");
+}
+
+/** db2ExecuteAsyncSync
+ *   Wait until the helper thread of a statement handle has finished the
+ *   execution handed to it, without checking the result; db2ExecuteWait
+ *   does that later. Used before a savepoint is set, so that a row of an
+ *   outer subtransaction is not executed after the savepoint.
+ */
+void db2ExecuteAsyncSync (HdlEntry* handlep) {
+  DB2AsyncExec* async = handlep->async;
+
+  if (async == NULL)
+    return;
+  db2Debug1("> db2ExecuteAsyncSync");
+  pthread_mutex_lock (&async->mutex);
+  if (async->pending && !async->done) {
+    db2WaitStart (DB2_WAIT_EXECUTE);
+    while (async->pending && !async->done)
+      pthread_cond_wait (&async->cond, &async->mutex);
+    db2WaitEnd ();
+  }
+  pthread_mutex_unlock (&async->mutex);
+  db2Debug1("< db2ExecuteAsyncSync");
+}
+
+/** db2ExecuteAsyncAbort
+ *   Called before a rollback to a savepoint: an execution still in progress
+ *   belongs to a row of the aborted subtransaction (rows of outer levels were
+ *   waited for by db2SetSavepoint), so cancel it and end the thread, lest
+ *   the row be executed after the rollback. A finished execution may be an
+ *   outer row whose result is still to be checked and is left alone.
+ */
+void db2ExecuteAsyncAbort (HdlEntry* handlep) {
+  DB2AsyncExec* async = handlep->async;
+  int           busy  = 0;
+
+  if (async == NULL)
+    return;
+  pthread_mutex_lock (&async->mutex);
+  busy = async->pending && !async->done;
+  pthread_mutex_unlock (&async->mutex);
+  if (busy)
+    db2ExecuteAsyncStop (handlep);
+}
+
+/** db2ExecuteThread
+ *   Body of the helper thread: execute the statement whenever the backend
+ *   hands over a row, until the backend stops the thread.
+ *   Runs in a helper thread, see db2StartThread.
+ */
+void* db2ExecuteThread (void* arg) {
+  DB2AsyncExec* async    = (DB2AsyncExec*) arg;
+  SQLRETURN     rc       = 0;
+  SQLLEN        rowcount = 0;
+  double        started  = 0;
+
+  pthread_mutex_lock (&async->mutex);
+  for (;;) {
+    while (!async->stop && !(async->pending && !async->done))
+      pthread_cond_wait (&async->cond, &async->mutex);
+    if (async->stop)
+      break;
+    pthread_mutex_unlock (&async->mutex);
+    started  = db2MetricsNow ();
+    rowcount = 0;
+    rc       = SQLExecute (async->hsql);
+    /* SQLRowCount would clear the diagnostics of a failure */
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)
+      SQLRowCount (async->hsql, &rowcount);
+    pthread_mutex_lock (&async->mutex);
+    async->rc       = rc;
+    async->rowcount = rowcount;
+    async->exec_ms  = db2MetricsNow () - started;
+    async->done     = 1;
+    pthread_cond_broadcast (&async->cond);
+  }
+  pthread_mutex_unlock (&async->mutex);
+  return NULL;
+}
@@ -15,15 +15,16 @@ extern int          err_code;              /* error code, set by db2CheckErr()
 /** external prototypes */
 extern void*        db2alloc             (const char* type, size_t size);
 extern void         db2free              (void* p);
-extern void         db2Debug1            (const char* message, ...);
-extern void         db2Debug2            (const char* message, ...);
-extern void         db2Debug3            (const char* message, ...);
 extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
 extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
 extern SQLSMALLINT  param2c              (SQLSMALLINT fcType);
 extern void         parse2num_struct     (const char* s, SQL_NUMERIC_STRUCT* ns);
 extern char*        c2name               (short fcType);
 extern void         db2BindParameter     (DB2Session* session, const DB2Table* db2Table, ParamDesc* param, SQLLEN* indicators, int param_count, int col_num);
+extern SQLRETURN    db2PutData           (DB2Session* session, SQLRETURN status);
+extern double       db2MetricsNow        (void);
+extern void         db2WaitStart         (db2WaitEvent event);
+extern void         db2WaitEnd           (void);
 
 /** internal prototypes */
 int                 db2ExecuteQuery      (DB2Session* session, const DB2Table* db2Table, ParamDesc* paramList);
@@ -43,6 +44,7 @@ int db2ExecuteQuery (DB2Session* session, const DB2Table* db2Table, ParamDesc* p
   SQLCHAR     cname[256]   = {0};  /* 256 is usually plenty; see note below */
   int         rowcount     = 0;
   int         param_count  = 0;
+  double      started      = 0;
   
   db2Debug1("> db2ExecureQuery");
   for (param = paramList; param != NULL; param = param->next) {
@@ -67,7 +69,17 @@ int db2ExecuteQuery (DB2Session* session, const DB2Table* db2Table, ParamDesc* p
     db2Error_d(FDW_UNABLE_TO_CREATE_EXECUTION, "error executing query: SQLGetCusorName failed to obtain cursor name", db2Message);
   }
   db2Debug2("  cursor name: '%s'", cname);
+  if (session->metrics != NULL)
+    started = db2MetricsNow ();
+  db2WaitStart (DB2_WAIT_EXECUTE);
   rc = SQLExecute (session->stmtp->hsql);
+  db2WaitEnd ();
+  /* LOB parameters are sent only now */
+  rc = db2PutData (session, rc);
+  if (session->metrics != NULL) {
+    session->metrics->execute_ms += db2MetricsNow () - started;
+    ++session->metrics->executions;
+  }
   rc = db2CheckErr(rc, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
   if (rc != SQL_SUCCESS && rc != SQL_NO_DATA) {
     /* use the correct SQLSTATE for serialization failures */
@@ -11,11 +11,12 @@ extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set b
 extern int          err_code;              /* error code, set by db2CheckErr()                              */
 
 /** external prototypes */
-extern void         db2Debug1            (const char* message, ...);
-extern void         db2Debug2            (const char* message, ...);
 extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
 extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
 extern HdlEntry*    db2AllocStmtHdl      (SQLSMALLINT type, DB2ConnEntry* connp, db2error error, const char* errmsg);
+extern void         db2Transactional     (DB2ConnEntry* connp);
+extern void         db2WaitStart         (db2WaitEvent event);
+extern void         db2WaitEnd           (void);
 
 /** internal prototypes */
 int                 db2ExecuteTruncate   (DB2Session* session, const char* query);
@@ -29,19 +30,24 @@ int db2ExecuteTruncate   (DB2Session* session, const char* query) {
   
   db2Debug1("> db2ExecuteTruncate(DB2Session: %x, query: %s)",session,query);
 
+  db2WaitStart (DB2_WAIT_COMMIT);
   rc = SQLEndTran(SQL_HANDLE_DBC, session->connp->hdbc, SQL_COMMIT);
+  db2WaitEnd ();
   rc = db2CheckErr(rc, session->connp->hdbc, SQL_HANDLE_DBC, __LINE__, __FILE__);
   if (rc  != SQL_SUCCESS) {
     db2Error_d (FDW_UNABLE_TO_CREATE_EXECUTION, "error committing transaction: SQLEndTran failed", db2Message);
   }
+  /* the truncation is only final once the remote transaction is committed */
+  db2Transactional (session->connp);
   session->stmtp = db2AllocStmtHdl(SQL_HANDLE_STMT, session->connp, FDW_UNABLE_TO_CREATE_EXECUTION, "error executing query: failed to allocate statement handle");
+  db2WaitStart (DB2_WAIT_EXECUTE);
   rc = SQLExecDirect(session->stmtp->hsql, (SQLCHAR*) query, SQL_NTS);
+  db2WaitEnd ();
   rc = db2CheckErr(rc, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
   if (rc != SQL_SUCCESS && rc != SQL_NO_DATA) {
     /* use the correct SQLSTATE for serialization failures */
     db2Error_d(err_code == 8177 ? FDW_SERIALIZATION_FAILURE : FDW_UNABLE_TO_CREATE_EXECUTION, "error executing query: SQLExecute failed to execute remote query", db2Message);
   }
-
   db2Debug2("  rowcount_val: %lld", rowcount_val);
   rowcount = (int) rowcount_val;
   db2Debug1("< db2ExecuteTruncate - returns: %d",rowcount);
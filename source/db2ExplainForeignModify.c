@@ -1,6 +1,7 @@
 #include <postgres.h>
 #include <commands/explain.h>
 #if PG_VERSION_NUM >= 180000
+#include <commands/explain_state.h>
 #include <commands/explain_format.h>
 #endif
 #include <nodes/pathnodes.h>
@@ -10,8 +11,7 @@
 #include "DB2FdwState.h"
 
 /** external prototypes */
-extern void            db2Debug1                 (const char* message, ...);
-extern void            db2Debug2                 (const char* message, ...);
+extern void db2ExplainMetrics (DB2Metrics* metrics, struct ExplainState* es);
 
 /** local prototypes */
 void db2ExplainForeignModify (ModifyTableState* mtstate, ResultRelInfo* rinfo, List* fdw_private, int subplan_index, struct ExplainState* es);
@@ -26,6 +26,9 @@ void db2ExplainForeignModify (ModifyTableState* mtstate, ResultRelInfo* rinfo, L
   db2Debug2("  relid: %d", RelationGetRelid (rinfo->ri_RelationDesc));
   /* show query */
   ExplainPropertyText ("DB2 statement", fdw_state->query, es);
+  if (es->analyze && fdw_state->metrics != NULL) {
+    db2ExplainMetrics (fdw_state->metrics, es);
+  }
   db2Debug1("< db2ExplainForeignModify");
 }
 
@@ -9,10 +9,13 @@ extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set b
 extern int          err_code;              /* error code, set by db2CheckErr()                              */
 
 /** external prototypes */
-extern void      db2Debug1            (const char* message, ...);
 extern void      db2Error             (db2error sqlstate, const char* message);
 extern void      db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
 extern SQLRETURN db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
+extern double    db2MetricsNow        (void);
+extern void      db2WaitStart         (db2WaitEvent event);
+extern void      db2WaitEnd           (void);
+extern int       db2PrefetchNext      (DB2Session* session);
 
 /** local prototypes */
 int db2FetchNext (DB2Session* session);
@@ -21,14 +24,30 @@ int db2FetchNext (DB2Session* session);
  *   Fetch the next result row, return 1 if there is one, else 0.
  */
 int db2FetchNext (DB2Session* session) {
-  SQLRETURN rc = 0;
+  SQLRETURN rc      = 0;
+  double    started = 0;
   db2Debug1("> db2FetchNext");
   /* make sure there is a statement handle stored in "session" */
   if (session->stmtp == NULL) {
     db2Error (FDW_ERROR, "db2FetchNext internal error: statement handle is NULL");
   }
+  /* a fetch thread may already have the row */
+  if (session->stmtp->prefetch != NULL) {
+    db2Debug1("< db2FetchNext - from fetch thread");
+    return db2PrefetchNext (session);
+  }
   /* fetch the next result row */
+  if (session->metrics != NULL)
+    started = db2MetricsNow ();
+  db2WaitStart (DB2_WAIT_FETCH);
   rc = SQLFetchScroll (session->stmtp->hsql, SQL_FETCH_NEXT, 1);
+  db2WaitEnd ();
+  if (session->metrics != NULL) {
+    session->metrics->fetch_ms += db2MetricsNow () - started;
+    ++session->metrics->fetch_calls;
+    if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)
+      ++session->metrics->rows;
+  }
   rc = db2CheckErr(rc, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
   if (rc != SQL_SUCCESS && rc != SQL_NO_DATA) {
     db2Error_d (err_code == 8177 ? FDW_SERIALIZATION_FAILURE : FDW_UNABLE_TO_CREATE_EXECUTION, "error fetching result: SQLFetchScroll failed to fetch next result row", db2Message);
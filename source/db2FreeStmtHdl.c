@@ -5,11 +5,10 @@
 /** external variables */
 
 /** external prototypes */
-extern void      db2Debug1            (const char* message, ...);
-extern void      db2Debug2            (const char* message, ...);
-extern void      db2Debug3            (const char* message, ...);
 extern void      db2Error             (db2error sqlstate, const char* message);
 extern SQLRETURN db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
+extern void      db2PrefetchStop      (HdlEntry* handlep);
+extern void      db2ExecuteAsyncStop  (HdlEntry* handlep);
 
 /** local prototypes */
 void             db2FreeStmtHdl       (HdlEntry* handlep, DB2ConnEntry* connp);
@@ -32,6 +31,10 @@ void db2FreeStmtHdl (HdlEntry* handlep, DB2ConnEntry* connp) {
   /* remember prev_entryp might be actually the root element at conp->handlelist*/
   db2Debug3("  prev_entryp: %x ->hsql : %d ->type : %d->next : %x", prev_entryp, prev_entryp->hsql, prev_entryp->type, prev_entryp->next);
 
+  /* fetch and execute threads must be gone before their statement handle */
+  db2PrefetchStop (handlep);
+  db2ExecuteAsyncStop (handlep);
+
   /* release the handle */
   rc = SQLFreeHandle(handlep->type, handlep->hsql);
   rc = db2CheckErr(rc, handlep->hsql, handlep->type, __LINE__, __FILE__ );
@@ -11,11 +11,8 @@
 /** external prototypes */
 extern char*        guessNlsLang              (char* nls_lang);
 extern void         db2GetOptions             (Oid foreigntableid, List** options);
-extern DB2Session*  db2GetSession             (const char* connectstring, char* user, char* password, char* jwt_token, const char* nls_lang, int curlevel);
+extern DB2Session*  db2GetSession             (const char* connectstring, char* user, char* password, char* jwt_token, const char* nls_lang);
 extern DB2Table*    db2Describe               (DB2Session* session, char* schema, char* table, char* pgname, long max_long, char* noencerr, char* batchsz);
-extern void         db2Debug1                 (const char* message, ...);
-extern void         db2Debug2                 (const char* message, ...);
-extern void         db2Debug3                 (const char* message, ...);
 extern void*        db2alloc                  (const char* type, size_t size);
 extern char*        db2strdup                 (const char* source);
 
@@ -43,6 +40,10 @@ DB2FdwState* db2GetFdwState (Oid foreigntableid, double *sample_percent, bool de
   char*        fetch        = NULL;
   char*        noencerr     = NULL;
   char*        batchsz      = NULL;
+  char*        isolation    = NULL;
+  char*        timeout      = NULL;
+  char*        maxqueries   = NULL;
+  char*        readpolicy   = NULL;
   long         max_long     = DEFAULT_MAX_LONG;
 
   db2Debug1("> db2GetFdwState");
@@ -76,6 +77,16 @@ DB2FdwState* db2GetFdwState (Oid foreigntableid, double *sample_percent, bool de
       noencerr = STRVAL(def->arg);
     if (strcmp (def->defname, OPT_BATCH_SIZE) == 0)
       batchsz  = STRVAL(def->arg);
+    if (strcmp (def->defname, OPT_ISOLATION_LEVEL) == 0)
+      isolation = STRVAL(def->arg);
+    if (strcmp (def->defname, OPT_QUERY_TIMEOUT) == 0)
+      timeout   = STRVAL(def->arg);
+    if (strcmp (def->defname, OPT_MAX_CONCURRENT_QUERIES) == 0)
+      maxqueries = STRVAL(def->arg);
+    if (strcmp (def->defname, OPT_READ_SERVERS) == 0)
+      fdwState->read_servers = STRVAL(def->arg);
+    if (strcmp (def->defname, OPT_READ_POLICY) == 0)
+      readpolicy = STRVAL(def->arg);
   }
 
   /* convert "max_long" option to number or use default */
@@ -92,6 +103,23 @@ DB2FdwState* db2GetFdwState (Oid foreigntableid, double *sample_percent, bool de
   /* convert "prefetch" to number (or use default) */
   fdwState->prefetch = (fetch == NULL) ? DEFAULT_PREFETCH : (unsigned long) strtoul (fetch, NULL, 0);
 
+  /* convert "query_timeout" to number, 0 means no limit */
+  fdwState->query_timeout = (timeout == NULL) ? 0 : (int) strtol (timeout, NULL, 0);
+
+  /* convert "max_concurrent_queries" to number, 0 means no limit */
+  fdwState->max_queries = (maxqueries == NULL) ? 0 : (int) strtol (maxqueries, NULL, 0);
+
+  /* "read_policy" defaults to round robin */
+  fdwState->read_policy = (readpolicy != NULL && pg_strcasecmp (readpolicy, "least_loaded") == 0) ? DB2_READ_LEAST_LOADED : DB2_READ_ROUND_ROBIN;
+
+  /* the isolation clause is appended to remote queries in upper case */
+  if (isolation != NULL) {
+    char* p;
+    fdwState->isolation = db2strdup (isolation);
+    for (p = fdwState->isolation; *p != '\0'; ++p)
+      *p = pg_toupper ((unsigned char) *p);
+  }
+
   /* check if options are ok */
   if (table == NULL)
     ereport (ERROR, (errcode (ERRCODE_FDW_OPTION_NAME_NOT_FOUND), errmsg ("required option \"%s\" in foreign table \"%s\" missing", OPT_TABLE, pgtablename)));
@@ -100,7 +128,7 @@ DB2FdwState* db2GetFdwState (Oid foreigntableid, double *sample_percent, bool de
   fdwState->nls_lang = guessNlsLang (fdwState->nls_lang);
 
   /* connect to DB2 database */
-  fdwState->session = db2GetSession (fdwState->dbserver, fdwState->user, fdwState->password, fdwState->jwt_token, fdwState->nls_lang, GetCurrentTransactionNestLevel () );
+  fdwState->session = db2GetSession (fdwState->dbserver, fdwState->user, fdwState->password, fdwState->jwt_token, fdwState->nls_lang);
 
   if (describe) {
     /* get remote table description */
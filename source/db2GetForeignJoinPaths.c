@@ -8,7 +8,6 @@
 #include "DB2FdwState.h"
 
 /** external prototypes */
-extern void         db2Debug1                 (const char* message, ...);
 extern char*        deparseExpr               (DB2Session* session, RelOptInfo * foreignrel, Expr* expr, const DB2Table* db2Table, List** params);
 extern char*        db2strdup                 (const char* source);
 extern void*        db2alloc                  (const char* type, size_t size);
@@ -151,6 +150,11 @@ bool foreign_join_ok (PlannerInfo * root, RelOptInfo * joinrel, JoinType jointyp
   if (fdwState_o->local_conds || fdwState_i->local_conds)
     return false;
 
+  /* both sides must be read with the same isolation level */
+  if ((fdwState_o->isolation == NULL) != (fdwState_i->isolation == NULL)
+  ||  (fdwState_o->isolation != NULL && strcmp (fdwState_o->isolation, fdwState_i->isolation) != 0))
+    return false;
+
   /* Separate restrict list into join quals and quals on join relation */
 
   /*
@@ -226,11 +230,23 @@ bool foreign_join_ok (PlannerInfo * root, RelOptInfo * joinrel, JoinType jointyp
   else
     fdwState->prefetch = fdwState_i->prefetch;
 
+  /* use the stricter query timeout of the joining sides */
+  if (fdwState_o->query_timeout == 0 || (fdwState_i->query_timeout != 0 && fdwState_i->query_timeout < fdwState_o->query_timeout))
+    fdwState->query_timeout = fdwState_i->query_timeout;
+  else
+    fdwState->query_timeout = fdwState_o->query_timeout;
+
+  /* both sides use the same foreign server */
+  fdwState->max_queries  = fdwState_o->max_queries;
+  fdwState->read_servers = fdwState_o->read_servers;
+  fdwState->read_policy  = fdwState_o->read_policy;
+
   /* copy outerrel's infomation to fdwstate */
   fdwState->dbserver = fdwState_o->dbserver;
   fdwState->user     = fdwState_o->user;
   fdwState->password = fdwState_o->password;
   fdwState->nls_lang = fdwState_o->nls_lang;
+  fdwState->isolation = fdwState_o->isolation;
 
   /* construct db2Table for the result of join */
   db2Table_o = fdwState_o->db2Table;
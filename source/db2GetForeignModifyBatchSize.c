@@ -10,7 +10,6 @@
 /** external variables */
 
 /** external prototypes */
-extern void            db2Debug1                 (const char* message, ...);
 
 /** local prototypes */
 int db2_get_batch_size_option   (Relation rel);
@@ -8,7 +8,6 @@
 #include "DB2FdwState.h"
 
 /** external prototypes */
-extern void         db2Debug1                 (const char* message, ...);
 extern char*        deparseExpr               (DB2Session* session, RelOptInfo * foreignrel, Expr* expr, const DB2Table* db2Table, List** params);
 
 /** local prototypes */
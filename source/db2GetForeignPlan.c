@@ -13,9 +13,6 @@
 extern List*        serializePlanData         (DB2FdwState* fdwState);
 extern char*        deparseExpr               (DB2Session* session, RelOptInfo * foreignrel, Expr* expr, const DB2Table* db2Table, List** params);
 extern void         checkDataType             (short db2type, int scale, Oid pgtype, const char* tablename, const char* colname);
-extern void         db2Debug1                 (const char* message, ...);
-extern void         db2Debug2                 (const char* message, ...);
-extern void         db2Debug3                 (const char* message, ...);
 extern void         db2free                   (void* p);
 extern char*        db2strdup                 (const char* p);
 
@@ -241,6 +238,10 @@ char* createQuery (DB2FdwState* fdwState, RelOptInfo* foreignrel, bool modify, L
   if (modify)
     appendStringInfo (&query, " FOR UPDATE");
 
+  /* append isolation clause, uncommitted read cannot be used FOR UPDATE */
+  if (fdwState->isolation && !(modify && strcmp (fdwState->isolation, "UR") == 0))
+    appendStringInfo (&query, " WITH %s", fdwState->isolation);
+
   /* get a copy of the where clause without single quoted string literals */
   wherecopy = db2strdup (query.data);
   for (p = wherecopy; *p != '\0'; ++p) {
@@ -12,14 +12,13 @@ extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set b
 /** external prototypes */
 extern void*        db2alloc             (const char* type, size_t size);
 extern void         db2free              (void* p);
-extern void         db2Debug1            (const char* message, ...);
-extern void         db2Debug2            (const char* message, ...);
-extern void         db2Debug3            (const char* message, ...);
 extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
 extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
 extern char*        c2name               (short fcType);
 extern HdlEntry*    db2AllocStmtHdl      (SQLSMALLINT type, DB2ConnEntry* connp, db2error error, const char* errmsg);
 extern void         db2FreeStmtHdl       (HdlEntry* handlep, DB2ConnEntry* connp);
+extern void         db2WaitStart         (db2WaitEvent event);
+extern void         db2WaitEnd           (void);
 
 /** internal prototypes */
 int                 db2GetImportColumn   (DB2Session* session, char* schema, char* table_list, int list_type, char* tabname, char* colName, short* colType, size_t* colLen, short* colScale, short* colNulls, int* key, int* cp);
@@ -69,7 +68,9 @@ int db2GetImportColumn(DB2Session* session, char* schema, char* table_list, int
     db2Debug2("  session->stmp->hsql : %d",session->stmtp->hsql);
     db2Debug2("  session->stmp->type : %d",session->stmtp->type);
     /* prepare the query */
+    db2WaitStart (DB2_WAIT_PREPARE);
     result = SQLPrepare(session->stmtp->hsql, (SQLCHAR*)schema_query, SQL_NTS);
+    db2WaitEnd ();
     db2Debug2("  SQLPrepare rc       : %d",result);
     result = db2CheckErr(result, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
     if (result != SQL_SUCCESS) {
@@ -93,13 +94,17 @@ int db2GetImportColumn(DB2Session* session, char* schema, char* table_list, int
     }
 
     /* execute the query and get the first result row */
+    db2WaitStart (DB2_WAIT_EXECUTE);
     result = SQLExecute(session->stmtp->hsql);
+    db2WaitEnd ();
     db2Debug2("  SQLExecute rc : %d",result);
     result = db2CheckErr(result, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
     if (result != SQL_SUCCESS) {
       db2Error_d (FDW_UNABLE_TO_CREATE_EXECUTION, "error importing foreign schema: SQLExecute failed to execute schema query", db2Message);
     } else {
+      db2WaitStart (DB2_WAIT_FETCH);
       result = SQLFetch(session->stmtp->hsql);
+      db2WaitEnd ();
       db2Debug2("  SQLFetch rc : %d, count = %lld, ind_c = %d",result, (long long)count, ind_c);
       result = db2CheckErr(result, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
       if (result != SQL_SUCCESS) {
@@ -164,7 +169,9 @@ int db2GetImportColumn(DB2Session* session, char* schema, char* table_list, int
     session->stmtp = db2AllocStmtHdl(SQL_HANDLE_STMT, session->connp, FDW_UNABLE_TO_CREATE_EXECUTION, "error importing foreign schema: failed to allocate statement handle");
 
     /* prepare the query */
+    db2WaitStart (DB2_WAIT_PREPARE);
     result = SQLPrepare(session->stmtp->hsql, (SQLCHAR*)column_query, SQL_NTS);
+    db2WaitEnd ();
     db2Debug2("  SQLPrepare rc : %d",result);
     result = db2CheckErr(result, session->stmtp->hsql, session->stmtp->type,  __LINE__, __FILE__);
     if (result != SQL_SUCCESS) {
@@ -236,7 +243,9 @@ int db2GetImportColumn(DB2Session* session, char* schema, char* table_list, int
     }
 
     /* execute the query and get the first result row */
+    db2WaitStart (DB2_WAIT_EXECUTE);
     result = SQLExecute (session->stmtp->hsql);
+    db2WaitEnd ();
     db2Debug2("  SQLExecute rc : %d",result);
     result = db2CheckErr(result, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
     if (result != SQL_SUCCESS && result != SQL_NO_DATA) {
@@ -248,7 +257,9 @@ int db2GetImportColumn(DB2Session* session, char* schema, char* table_list, int
   /* for any subsequent call, just fetch the next row from that cursor */
   if (session->stmtp != NULL) {
     /* fetch the next result row */
+    db2WaitStart (DB2_WAIT_FETCH);
     result = SQLFetch(session->stmtp->hsql);
+    db2WaitEnd ();
     result = db2CheckErr(result, session->stmtp->hsql, session->stmtp->type,  __LINE__, __FILE__);
     if (result != SQL_SUCCESS && result != SQL_NO_DATA) {
       db2Error_d (FDW_UNABLE_TO_CREATE_EXECUTION, "error importing foreign schema: SQLFetchScroll failed to fetch next result row", db2Message);
@@ -4,6 +4,7 @@
 #include "db2_fdw.h"
 
 /** global variables */
+int                 db2LobChunkSize = DEFAULT_LOB_CHUNK_SIZE; /* bytes per SQLGetData call, set by db2_fdw.lob_chunk_size */
 
 /** external variables */
 extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
@@ -11,89 +12,109 @@ extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set b
 /** external prototypes */
 extern void*        db2alloc             (const char* type, size_t size);
 extern void*        db2realloc           (void* p, size_t size);
-extern void         db2Debug1            (const char* message, ...);
-extern void         db2Debug2            (const char* message, ...);
-extern void         db2Debug3            (const char* message, ...);
 extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
 extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
+extern double       db2MetricsNow        (void);
+extern void         db2WaitStart         (db2WaitEvent event);
+extern void         db2WaitEnd           (void);
+extern void         db2CheckInterrupts   (void);
 
 /** internal prototypes */
-void                db2GetLob            (DB2Session* session, DB2Column* column, int cidx, char** value, long* value_len, unsigned long trunc);
+void                db2GetLob            (DB2Session* session, DB2Column* column, int cidx, char** value, long* value_len, unsigned long trunc, size_t hdrsz);
 
 /** db2GetLob
  *   Get the LOB contents and store them in *value and *value_len.
- *   If "trunc" is nonzero, it contains the number of bytes or characters to get.
+ *   The data start "hdrsz" bytes into the allocated buffer, so that the
+ *   caller can put a varlena header in front of them without copying.
+ *   The total length is asked for first, so that the buffer is normally
+ *   allocated once and filled in chunks of db2LobChunkSize bytes.
+ *   If "trunc" is nonzero, it contains the number of bytes to get; reading
+ *   stops there, so the remainder of the LOB is never sent by the server.
  */
-void db2GetLob (DB2Session* session, DB2Column* column, int cidx, char** value, long* value_len, unsigned long trunc) {
-  SQLRETURN      rc  = SQL_SUCCESS;
-  SQLLEN         ind = 0;
-  SQLCHAR        buf[LOB_CHUNK_SIZE+1];
-  int            extend = 0;
+void db2GetLob (DB2Session* session, DB2Column* column, int cidx, char** value, long* value_len, unsigned long trunc, size_t hdrsz) {
+  SQLRETURN      rc     = SQL_SUCCESS;
+  SQLRETURN      status = SQL_SUCCESS;
+  SQLLEN         ind    = 0;
+  SQLSMALLINT    ctype  = (column->colType == SQL_BLOB) ? SQL_C_BINARY : SQL_C_CHAR;
+  SQLLEN         term   = (ctype == SQL_C_CHAR) ? 1 : 0;
+  SQLLEN         room   = 0;
+  SQLLEN         chunk  = 0;
+  size_t         size   = 0;
+  SQLCHAR        probe[1];
+  double         started = (session->metrics != NULL) ? db2MetricsNow () : 0;
   db2Debug1("> db2GetLob");
   db2Debug2("  column->colName: '%s'",column->colName);
   db2Debug2("  cidx           :  %d ",cidx);
-  /* initialize result buffer length */
+  *value     = NULL;
   *value_len = 0;
-  /* read the LOB in chunks */
+
+  /* ask for the total length without transferring any data */
+  db2WaitStart (DB2_WAIT_LOB_READ);
+  status = SQLGetData(session->stmtp->hsql, cidx, ctype, probe, 0, &ind);
+  db2WaitEnd ();
+  rc     = db2CheckErr(status, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
+  if (rc == SQL_ERROR) {
+    db2Error_d ( FDW_UNABLE_TO_CREATE_EXECUTION, "error fetching result: SQLGetData failed to get LOB length", db2Message);
+  }
+  if (rc == 100 || ind == SQL_NULL_DATA) {
+    db2Debug3("  not allocating space since the LOB value is NULL");
+    if (session->metrics != NULL)
+      session->metrics->lob_ms += db2MetricsNow () - started;
+    db2Debug1("< db2GetLob");
+    return;
+  }
+  /* allocate the result once if the length is known, otherwise start with one chunk */
+  size = (ind == SQL_NO_TOTAL) ? (size_t) db2LobChunkSize : (size_t) ind;
+  /* only the first "trunc" bytes are read, the rest is never transferred */
+  if (trunc > 0 && size > trunc) {
+    size = trunc;
+  }
+  db2Debug2("  total length: %ld", (long) ind);
+  *value = db2alloc ("lob_value", hdrsz + size + 1);
+  if (ind == 0) {
+    db2Debug3("  LOB value is empty");
+    if (session->metrics != NULL)
+      session->metrics->lob_ms += db2MetricsNow () - started;
+    db2Debug1("< db2GetLob");
+    return;
+  }
+
+  /* read the LOB in chunks directly into the result */
   do {
-    db2Debug2("  value_len: %ld",*value_len);
-    db2Debug2("  reading %d byte chunck of data",sizeof(buf));
-    rc = SQLGetData(session->stmtp->hsql, cidx, SQL_C_CHAR, buf, sizeof(buf), &ind);
-    rc = db2CheckErr(rc,session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
+    /* a large LOB must not delay a cancel request */
+    db2CheckInterrupts ();
+    if ((size_t) *value_len >= size) {
+      /* the length was unknown or too small, grow geometrically */
+      size  += (size > (size_t) db2LobChunkSize) ? size : (size_t) db2LobChunkSize;
+      *value = db2realloc (*value, hdrsz + size + 1);
+      db2Debug3("  extended LOB buffer to %ld bytes", (long) size);
+    }
+    room  = (SQLLEN) (size - *value_len);
+    if (trunc > 0 && room > (SQLLEN) (trunc - *value_len)) {
+      room = (SQLLEN) (trunc - *value_len);
+    }
+    chunk = (room < db2LobChunkSize) ? room : db2LobChunkSize;
+    db2Debug2("  reading %ld byte chunk of data at offset %ld", (long) chunk, *value_len);
+    db2WaitStart (DB2_WAIT_LOB_READ);
+    status = SQLGetData(session->stmtp->hsql, cidx, ctype, *value + hdrsz + *value_len, chunk + term, &ind);
+    db2WaitEnd ();
+    rc     = db2CheckErr(status, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
     if (rc == SQL_ERROR) {
       db2Error_d ( FDW_UNABLE_TO_CREATE_EXECUTION, "error fetching result: SQLGetData failed to read LOB chunk", db2Message);
     }
-    if (rc != 100) {
-      switch(ind) {
-        case SQL_NULL_DATA:
-          db2Debug3("  data length is null (SQL_NULL_DATA)");
-          extend = 0;
-        break;
-        case SQL_NO_TOTAL:
-          db2Debug3("  undefined data length (SQL_NO_TOTAL)");
-          extend = LOB_CHUNK_SIZE;
-        break;
-        default:
-          db2Debug3("  bytes still remaining: %d", ind);
-          extend = (ind < LOB_CHUNK_SIZE) ? ind : LOB_CHUNK_SIZE;
-        break;
-      }
-      /* extend result buffer by ind */
-      db2Debug2("  value_len: %ld", *value_len);
-      db2Debug2("  extend   : %d", extend);
-      if (*value_len == 0) {
-        if (extend > 0) {
-          *value = db2alloc ("lob_value", *value_len + extend + 1);
-        } else {
-          *value = NULL;
-          db2Debug3("  not allocating space since the LOB value is apparently NULL");
-        }
-      } else {
-        // do not add another 0 termination byte, since we already have one
-        *value = db2realloc (*value, *value_len + extend);
-      }
-      // append the buffer read to the value excluding 0 termination byte
-      db2Debug2("  *value    : %x", *value);
-      db2Debug2("  *value_len: %x", *value_len);
-      if (*value != NULL) {
-        db2Debug3("  memcpy(%x,%x,%d)",*value+*value_len,buf,extend);
-        memcpy(*value + *value_len, buf, extend);
-        /* update LOB length */
-        *value_len += extend;
-      } else {
-        db2Debug3("  skipping value copy, since value is NULL");
-      }
+    if (rc == 100) {
+      break;
     }
-  } while (rc == SQL_SUCCESS_WITH_INFO);
+    /* a truncated chunk filled the buffer, otherwise ind holds what was left */
+    *value_len += (status == SQL_SUCCESS_WITH_INFO && (ind == SQL_NO_TOTAL || ind > chunk)) ? chunk : ind;
+  } while (status == SQL_SUCCESS_WITH_INFO && (trunc == 0 || (unsigned long) *value_len < trunc));
 
   /* string end for CLOBs */
-  db2Debug2("  *value   : %x" , *value);
-  db2Debug2("  value_len: %ld", *value_len);
-  if (*value != NULL) {
-    (*value)[*value_len] = '\0';
-    db2Debug2("  strlen of lob: %ld", strlen(*value));
-  } else {
-    db2Debug2("  strlen of lob: 0 since *value is NULL");
+  (*value)[hdrsz + *value_len] = '\0';
+  if (session->metrics != NULL) {
+    session->metrics->lob_ms    += db2MetricsNow () - started;
+    session->metrics->lob_bytes += *value_len;
   }
+  db2Debug2("  value_len: %ld", *value_len);
   db2Debug1("< db2GetLob");
 }
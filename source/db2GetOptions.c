@@ -7,7 +7,6 @@
 #include "db2_fdw.h"
 
 /** external prototypes */
-extern void         db2Debug1                 (const char* message, ...);
 
 /** local prototypes */
 void db2GetOptions(Oid foreigntableid, List** options);
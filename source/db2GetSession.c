@@ -1,3 +1,4 @@
+#include <time.h>
 #include <sqlcli1.h>
 #include <postgres_ext.h>
 #include "db2_fdw.h"
@@ -9,23 +10,27 @@ extern DB2EnvEntry*  rootenvEntry;          /* contains DB2 error messages, set
 
 /** external prototypes */
 extern void*         db2alloc             (const char* type, size_t size);
-extern void          db2Debug1            (const char* message, ...);
-extern void          db2Debug2            (const char* message, ...);
 extern DB2ConnEntry* db2AllocConnHdl      (DB2EnvEntry* envp,const char* srvname, char* user, char* password, char* jwt_token, const char* nls_lang);
 extern DB2EnvEntry*  db2AllocEnvHdl       (const char* nls_lang);
 extern DB2EnvEntry*  findenvEntry         (DB2EnvEntry* start, const char* nlslang);
-extern DB2ConnEntry* findconnEntry        (DB2ConnEntry* start, const char* srvname, const char* user);
-extern void          db2SetSavepoint      (DB2Session* session, int nest_level);
+extern DB2ConnEntry* findconnEntry        (DB2EnvEntry* envp, const char* srvname, const char* user);
+extern void          db2ReapConnections   (DB2ConnEntry* keep);
+extern int           db2PingConnection    (DB2ConnEntry* connp);
+extern void          db2DropConnection    (DB2EnvEntry* envp, DB2ConnEntry* connp);
 
 /** local prototypes */
-DB2Session*          db2GetSession        (const char* srvname, char* user, char* password, char* jwt_token, const char* nls_lang, int curlevel);
+DB2Session*          db2GetSession        (const char* srvname, char* user, char* password, char* jwt_token, const char* nls_lang);
 
 /** db2GetSession
  * Look up an DB2 connection in the cache, create a new one if there is none.
  * The result is an allocated data structure containing the connection.
- * "curlevel" is the current PostgreSQL transaction level.
+ * No savepoints are set here; they are only needed once DB2 data is
+ * modified and are set by db2SetSavepoint from the DML code path.
+ * A cached connection that was idle for db2_fdw.connection_check_interval
+ * seconds is checked before it is reused and replaced if the server does not
+ * answer; other connections idle for db2_fdw.connection_idle_timeout are closed.
  */
-DB2Session* db2GetSession (const char* srvname, char* user, char* password, char* jwt_token, const char* nls_lang, int curlevel) {
+DB2Session* db2GetSession (const char* srvname, char* user, char* password, char* jwt_token, const char* nls_lang) {
   DB2Session*   session = NULL;
   DB2EnvEntry*  envp    = NULL;
   DB2ConnEntry* connp   = NULL;
@@ -44,7 +49,14 @@ DB2Session* db2GetSession (const char* srvname, char* user, char* password, char
   if (envp == NULL) {
     envp = db2AllocEnvHdl(nls_lang);
   }
-  connp = findconnEntry(envp->connlist, srvname, user);
+  connp = findconnEntry(envp, srvname, user);
+  if (connp != NULL && connp->xact_level <= 0 && connp->handlelist == NULL
+      && db2ConnCheckInterval > 0 && time(NULL) - connp->last_used >= db2ConnCheckInterval
+      && !db2PingConnection (connp)) {
+    db2Debug2("  db2_fdw::db2GetSession: cached connection is broken, reconnect");
+    db2DropConnection (envp, connp);
+    connp = NULL;
+  }
   if (connp == NULL){
     connp = db2AllocConnHdl(envp, srvname, user, password, jwt_token, NULL);
   }
@@ -52,15 +64,16 @@ DB2Session* db2GetSession (const char* srvname, char* user, char* password, char
     db2Debug2("  db2_fdw::db2GetSession: begin serializable remote transaction");
     connp->xact_level = 1;
   }
+  connp->uses++;
+  connp->last_used = time(NULL);
+  db2ReapConnections (connp);
 
   /* allocate a data structure pointing to the cached entries */
-  session        = db2alloc("session", sizeof (DB2Session));
-  session->envp  = envp;
-  session->connp = connp;
-  session->stmtp = NULL;
-
-  /* set savepoints up to the current level */
-  db2SetSavepoint (session, curlevel);
+  session          = db2alloc("session", sizeof (DB2Session));
+  session->envp    = envp;
+  session->connp   = connp;
+  session->stmtp   = NULL;
+  session->metrics = NULL;
 
   db2Debug1("< db2GetSession");
   return session;
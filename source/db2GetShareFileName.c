@@ -7,7 +7,6 @@
 #include "db2_fdw.h"
 
 /** external prototypes */
-extern void         db2Debug1                 (const char* message, ...);
 extern void*        db2alloc                  (const char* type, size_t size);
 
 /** local prototypes */
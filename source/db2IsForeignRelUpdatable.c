@@ -7,8 +7,6 @@
 
 /** external prototypes */
 extern bool            optionIsTrue              (const char* value);
-extern void            db2Debug1                 (const char* message, ...);
-extern void            db2Debug2                 (const char* message, ...);
 
 /** local prototypes */
 int db2IsForeignRelUpdatable(Relation rel);
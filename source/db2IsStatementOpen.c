@@ -7,7 +7,6 @@
 /** external variables */
 
 /** external prototypes */
-extern void          db2Debug1            (const char* message, ...);
 
 /** local prototypes */
 int                  db2IsStatementOpen   (DB2Session* session);
@@ -5,6 +5,7 @@
 #include <nodes/pathnodes.h>
 #include <optimizer/optimizer.h>
 #include <access/heapam.h>
+#include <utils/memutils.h>
 #include <access/xact.h>
 #include "db2_fdw.h"
 #include "DB2FdwState.h"
@@ -15,12 +16,18 @@ extern void         db2PrepareQuery           (DB2Session* session, const char*
 extern int          db2ExecuteQuery           (DB2Session* session, const DB2Table* db2Table, ParamDesc* paramList);
 extern int          db2FetchNext              (DB2Session* session);
 extern void         db2CloseStatement         (DB2Session* session);
-extern void         db2Debug1                 (const char* message, ...);
-extern void         db2Debug2                 (const char* message, ...);
-extern void         db2Debug3                 (const char* message, ...);
 extern void         convertTuple              (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trunc_lob) ;
 extern char*        deparseDate               (Datum datum);
 extern char*        deparseTimestamp          (Datum datum, bool hasTimezone);
+extern bool         setNativeParameter        (ParamDesc* param, Datum datum, Oid pgtype, short colType);
+extern void         db2SetQueryTimeout        (DB2Session* session, int timeout);
+extern int          db2QueryTimeout           (int timeout);
+extern void         db2QuerySlotAcquire       (const char* dbserver, int limit, DB2Metrics* metrics);
+extern void         db2QuerySlotRelease       (const char* dbserver);
+extern int          db2PrefetchStart          (DB2Session* session, DB2Table* db2Table, unsigned long prefetch, int execute);
+
+/** global variables */
+bool                db2FetchThread = false;   /* set by db2_fdw.fetch_thread */
 
 /** local prototypes */
 TupleTableSlot* db2IterateForeignScan(ForeignScanState* node);
@@ -51,21 +58,42 @@ TupleTableSlot* db2IterateForeignScan (ForeignScanState* node) {
     /* execute the DB2 statement and fetch the first row */
     db2Debug3("  execute query in foreign table scan '%s'", paramInfo);
     db2PrepareQuery (fdw_state->session, fdw_state->query, fdw_state->db2Table, fdw_state->prefetch);
+    db2SetQueryTimeout (fdw_state->session, db2QueryTimeout (fdw_state->query_timeout));
+    /* wait for admission if the server limits concurrent queries */
+    if (fdw_state->max_queries > 0 && !fdw_state->admitted) {
+      db2QuerySlotAcquire (fdw_state->dbserver, fdw_state->max_queries, fdw_state->metrics);
+      fdw_state->admitted = 1;
+    }
     have_result = db2ExecuteQuery (fdw_state->session, fdw_state->db2Table, fdw_state->paramList);
+    /* let a helper thread fetch the next rows while this one converts */
+    if (db2FetchThread)
+      db2PrefetchStart (fdw_state->session, fdw_state->db2Table, fdw_state->prefetch, 0);
     have_result = db2FetchNext (fdw_state->session);
   }
   /* initialize virtual tuple */
   ExecClearTuple (slot);
+  /* the previous row is no longer needed, release everything allocated for it */
+#if PG_VERSION_NUM >= 130000
+  fdw_state->peak_mem = Max (fdw_state->peak_mem, MemoryContextMemAllocated (fdw_state->temp_cxt, true));
+#endif
+  MemoryContextReset (fdw_state->temp_cxt);
   if (have_result) {
+    MemoryContext oldcontext;
     /* increase row count */
     ++fdw_state->rowcount;
     /* convert result to arrays of values and null indicators */
+    oldcontext = MemoryContextSwitchTo (fdw_state->temp_cxt);
     convertTuple (fdw_state, slot->tts_values, slot->tts_isnull, false);
+    MemoryContextSwitchTo (oldcontext);
     /* store the virtual tuple */
     ExecStoreVirtualTuple (slot);
   } else {
     /* close the statement */
     db2CloseStatement (fdw_state->session);
+    if (fdw_state->admitted) {
+      db2QuerySlotRelease (fdw_state->dbserver);
+      fdw_state->admitted = 0;
+    }
   }
   db2Debug1("< db2IterateForeignScan");
   return slot;
@@ -109,8 +137,11 @@ char* setSelectParameters (ParamDesc* paramList, ExprContext* econtext) {
       datum = ExecEvalExpr ((ExprState *) (param->node), econtext, &is_null);
     }
 
+    param->native = NATIVE_NONE;
     if (is_null) {
       param->value = NULL;
+    } else if (setNativeParameter (param, datum, param->type, 0)) {
+      /* integers and floating point values are bound in binary form */
     } else {
       if (param->type == DATEOID)
         param->value = deparseDate (datum);
@@ -119,28 +150,32 @@ char* setSelectParameters (ParamDesc* paramList, ExprContext* econtext) {
       else if (param->type == TIMEOID || param->type == TIMETZOID)
         param->value = deparseTimestamp (datum, false/*(param->type == TIMETZOID)*/);
       else {
-        regproc typoutput;
-
-        /* get the type's output function */
-        tuple = SearchSysCache1 (TYPEOID, ObjectIdGetDatum (param->type));
-        if (!HeapTupleIsValid (tuple)) {
-          elog (ERROR, "cache lookup failed for type %u", param->type);
+        /* get the type's output function only once */
+        if (param->outfunc == InvalidOid) {
+          tuple = SearchSysCache1 (TYPEOID, ObjectIdGetDatum (param->type));
+          if (!HeapTupleIsValid (tuple)) {
+            elog (ERROR, "cache lookup failed for type %u", param->type);
+          }
+          param->outfunc = ((Form_pg_type) GETSTRUCT (tuple))->typoutput;
+          ReleaseSysCache (tuple);
         }
-        typoutput = ((Form_pg_type) GETSTRUCT (tuple))->typoutput;
-        ReleaseSysCache (tuple);
 
         /* convert the parameter value into a string */
-        param->value = DatumGetCString (OidFunctionCall1 (typoutput, datum));
+        param->value = DatumGetCString (OidFunctionCall1 (param->outfunc, datum));
       }
     }
 
     /* build a parameter list for the DEBUG message */
-    if (first_param) {
-      first_param = false;
-      appendStringInfo (&info, ", parameters ?=\"%s\"", (param->value ? param->value : "(null)"));
-    } else {
-      appendStringInfo (&info, ", ?=\"%s\"", (param->value ? param->value : "(null)"));
-    }
+    appendStringInfo (&info, "%s", (first_param ? ", parameters " : ", "));
+    first_param = false;
+    if (param->value == NULL)
+      appendStringInfo (&info, "?=\"(null)\"");
+    else if (param->native == NATIVE_INT64)
+      appendStringInfo (&info, "?=\"%lld\"", param->buf.ival);
+    else if (param->native == NATIVE_DOUBLE)
+      appendStringInfo (&info, "?=\"%g\"", param->buf.dval);
+    else
+      appendStringInfo (&info, "?=\"%s\"", param->value);
   }
 
   /* reset memory context */
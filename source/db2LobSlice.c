@@ -0,0 +1,37 @@
+#include <postgres.h>
+#if PG_VERSION_NUM >= 130000
+#include <access/detoast.h>
+#else
+#include <access/tuptoaster.h>
+#define detoast_attr_slice heap_tuple_untoast_attr_slice
+#endif
+#include "db2_fdw.h"
+
+/** external prototypes */
+
+/** local prototypes */
+char* db2LobSlice      (void* lob, long offset, long length, void** slice);
+
+/** db2LobSlice
+ *   Return a pointer to "length" bytes of the LOB parameter value "lob",
+ *   starting at byte "offset".
+ *   A value that is still toasted is fetched one slice at a time, so it
+ *   never has to be in memory as a whole; *slice is then set to the
+ *   allocated slice, which the caller must free.  Otherwise *slice is NULL.
+ */
+char* db2LobSlice (void* lob, long offset, long length, void** slice) {
+  struct varlena* attr   = (struct varlena*) lob;
+  char*           result = NULL;
+  db2Debug4("> db2LobSlice");
+  db2Debug5("  offset: %ld, length: %ld", offset, length);
+  if (VARATT_IS_EXTENDED (attr)) {
+    struct varlena* part = detoast_attr_slice (attr, (int32) offset, (int32) length);
+    *slice = part;
+    result = VARDATA (part);
+  } else {
+    *slice = NULL;
+    result = VARDATA (attr) + offset;
+  }
+  db2Debug4("< db2LobSlice");
+  return result;
+}
@@ -0,0 +1,33 @@
+#include <time.h>
+#include <sqlcli1.h>
+#include <postgres_ext.h>
+#include "db2_fdw.h"
+
+/** global variables */
+
+/** external variables */
+
+/** external prototypes */
+
+/** local prototypes */
+void                db2SetMetrics        (DB2Session* session, DB2Metrics* metrics);
+double              db2MetricsNow        (void);
+
+/** db2SetMetrics
+ *   Collect execution statistics of "session" in "metrics" from now on.
+ *   Passing NULL switches collecting off again.
+ */
+void db2SetMetrics (DB2Session* session, DB2Metrics* metrics) {
+  db2Debug1("> db2SetMetrics");
+  session->metrics = metrics;
+  db2Debug1("< db2SetMetrics");
+}
+
+/** db2MetricsNow
+ *   Return a monotonic timestamp in milliseconds for measuring DB2 CLI calls.
+ */
+double db2MetricsNow (void) {
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec * 1000.0 + (double) ts.tv_nsec / 1000000.0;
+}
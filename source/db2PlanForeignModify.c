@@ -13,10 +13,6 @@
 extern char*        db2strdup                 (const char* source);
 extern void*        db2alloc                  (const char* type, size_t size);
 extern DB2FdwState* db2GetFdwState            (Oid foreigntableid, double* sample_percent, bool describe);
-extern void         db2Debug1                 (const char* message, ...);
-extern void         db2Debug2                 (const char* message, ...);
-extern void         db2Debug4                 (const char* message, ...);
-extern void         db2Debug5                 (const char* message, ...);
 extern short        c2dbType                  (short fcType);
 extern void         appendAsType              (StringInfoData* dest, Oid type);
 
@@ -329,6 +325,10 @@ DB2FdwState* copyPlanData (DB2FdwState* orig) {
   copy->user              = db2strdup(orig->user);
   copy->password          = db2strdup(orig->password);
   copy->nls_lang          = db2strdup(orig->nls_lang);
+  copy->query_timeout     = orig->query_timeout;
+  copy->max_queries       = orig->max_queries;
+  copy->read_servers      = db2strdup(orig->read_servers);
+  copy->read_policy       = orig->read_policy;
   copy->session           = NULL;
   copy->query             = NULL;
   copy->paramList         = NULL;
@@ -362,6 +362,8 @@ DB2FdwState* copyPlanData (DB2FdwState* orig) {
     copy->db2Table->cols[i]->val_size       = orig->db2Table->cols[i]->val_size;
     copy->db2Table->cols[i]->val_len        = 0;
     copy->db2Table->cols[i]->val_null       = 0;
+    copy->db2Table->cols[i]->lobInline      = orig->db2Table->cols[i]->lobInline;
+    copy->db2Table->cols[i]->convUtf8       = orig->db2Table->cols[i]->convUtf8;
   }
   copy->startup_cost = 0.0;
   copy->total_cost   = 0.0;
@@ -475,6 +477,14 @@ List* serializePlanData (DB2FdwState* fdwState) {
   result = lappend (result, serializeString (fdwState->query));
   /* DB2 prefetch count */
   result = lappend (result, serializeLong (fdwState->prefetch));
+  /* DB2 query timeout */
+  result = lappend (result, serializeInt (fdwState->query_timeout));
+  /* concurrent remote queries */
+  result = lappend (result, serializeInt (fdwState->max_queries));
+  /* read endpoints */
+  result = lappend (result, serializeString (fdwState->read_servers));
+  /* read routing policy */
+  result = lappend (result, serializeInt (fdwState->read_policy));
   /* DB2 table name */
   result = lappend (result, serializeString (fdwState->db2Table->name));
   /* PostgreSQL table name */
@@ -504,6 +514,8 @@ List* serializePlanData (DB2FdwState* fdwState) {
     result = lappend (result, serializeInt    (fdwState->db2Table->cols[idxCol]->pkey));
     result = lappend (result, serializeLong   (fdwState->db2Table->cols[idxCol]->val_size));
     result = lappend (result, serializeInt    (fdwState->db2Table->cols[idxCol]->noencerr));
+    result = lappend (result, serializeInt    (fdwState->db2Table->cols[idxCol]->lobInline));
+    result = lappend (result, serializeInt    (fdwState->db2Table->cols[idxCol]->convUtf8));
     /* don't serialize val, val_len, val_null and varno */
   }
 
@@ -0,0 +1,365 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sqlcli1.h>
+#include <postgres_ext.h>
+#include "db2_fdw.h"
+#include "ParamDesc.h"
+
+/** external variables */
+extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
+extern int          err_code;              /* error code, set by db2CheckErr()                              */
+
+/** external prototypes */
+extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
+extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
+extern short        c2dbType             (short fcType);
+extern SQLSMALLINT  db2ColumnCType       (DB2Column* column);
+extern double       db2MetricsNow        (void);
+extern void         db2WaitStart         (db2WaitEvent event);
+extern void         db2WaitEnd           (void);
+extern int          db2ExecuteQuery      (DB2Session* session, const DB2Table* db2Table, ParamDesc* paramList);
+extern int          db2StartThread       (void* (*body) (void*), void* arg, pthread_t* thread);
+
+/** local prototypes */
+int                 db2PrefetchStart     (DB2Session* session, DB2Table* db2Table, unsigned long prefetch, int execute);
+void                db2PrefetchExecute   (DB2Session* session, DB2Table* db2Table, unsigned long prefetch);
+int                 db2PrefetchNext      (DB2Session* session);
+void                db2PrefetchStop      (HdlEntry* handlep);
+void*               db2PrefetchThread    (void* arg);
+void                db2PrefetchFill      (DB2Prefetch* pf, DB2PrefetchBlock* blk);
+void                db2PrefetchFree      (DB2Prefetch* pf);
+size_t              db2PrefetchLen       (DB2Column* column, SQLLEN ind);
+
+/** db2PrefetchExecute
+ *   Execute the prepared query of "session" in a helper thread, which then
+ *   goes on fetching, and return at once.  If no thread can be used, the
+ *   query is executed by the backend before returning.
+ *   The query must not have parameters.
+ */
+void db2PrefetchExecute (DB2Session* session, DB2Table* db2Table, unsigned long prefetch) {
+  db2Debug1("> db2PrefetchExecute");
+  if (!db2PrefetchStart (session, db2Table, prefetch, 1))
+    db2ExecuteQuery (session, db2Table, NULL);
+  db2Debug1("< db2PrefetchExecute");
+}
+
+/** db2PrefetchStart
+ *   Hand the fetching of the query in "session" to a helper thread, which
+ *   fills one block of rows while the backend converts the other; with
+ *   "execute" the thread also executes the prepared query first.
+ *   Rows are taken with db2FetchNext as before.  Returns 1 if the thread runs.
+ *   Nothing happens if the query is FOR UPDATE, since reading ahead would
+ *   lock rows the backend has not asked for yet, if a LOB column is read
+ *   through a locator, since db2GetLob needs the cursor on the current row,
+ *   or if there is not enough memory for the buffers; the backend then
+ *   fetches the rows itself.
+ */
+int db2PrefetchStart (DB2Session* session, DB2Table* db2Table, unsigned long prefetch, int execute) {
+  DB2Prefetch* pf      = NULL;
+  SQLRETURN    rc      = 0;
+  size_t       rowmax  = 0;
+  int          col_pos = 0;
+  int          i;
+
+  db2Debug1("> db2PrefetchStart");
+  if (session->stmtp == NULL || session->stmtp->prefetch != NULL) {
+    db2Debug1("< db2PrefetchStart - no statement or thread already running");
+    return 0;
+  }
+  if (session->stmtp->for_update) {
+    db2Debug1("< db2PrefetchStart - query is FOR UPDATE");
+    return 0;
+  }
+  for (i = 0; i < db2Table->ncols; ++i) {
+    DB2Column* column = db2Table->cols[i];
+    if (!column->used)
+      continue;
+    if ((c2dbType (column->colType) == DB2_BLOB || c2dbType (column->colType) == DB2_CLOB) && !column->lobInline) {
+      db2Debug1("< db2PrefetchStart - column '%s' is read through a LOB locator", column->colName);
+      return 0;
+    }
+    rowmax += sizeof (SQLLEN) + column->val_size;
+  }
+
+  if ((pf = calloc (1, sizeof (DB2Prefetch))) == NULL) {
+    db2Debug1("< db2PrefetchStart - out of memory");
+    return 0;
+  }
+  pf->hsql      = session->stmtp->hsql;
+  pf->execute   = execute;
+  pf->db2Table  = db2Table;
+  pf->rowmax    = rowmax;
+  pf->blocksize = (rowmax > DB2_PREFETCH_BLOCK_SIZE) ? rowmax : DB2_PREFETCH_BLOCK_SIZE;
+  pf->blockrows = (prefetch > 0) ? (int) prefetch : 1;
+  pf->block[0].data = malloc (pf->blocksize);
+  pf->block[1].data = malloc (pf->blocksize);
+  pf->next      = pf->block[0].data;
+  pf->vals      = calloc (db2Table->ncols + 1, sizeof (char*));
+  pf->inds      = calloc (db2Table->ncols + 1, sizeof (SQLLEN));
+  for (i = 0; pf->vals != NULL && i < db2Table->ncols; ++i) {
+    if (db2Table->cols[i]->used && (pf->vals[i] = malloc (db2Table->cols[i]->val_size)) == NULL)
+      break;
+  }
+  if (pf->block[0].data == NULL || pf->block[1].data == NULL || pf->vals == NULL || pf->inds == NULL || i < db2Table->ncols) {
+    db2PrefetchFree (pf);
+    db2Debug1("< db2PrefetchStart - out of memory");
+    return 0;
+  }
+
+  /* nothing has been fetched yet, so the columns can still be bound elsewhere */
+  for (i = 0, col_pos = 0; i < db2Table->ncols; ++i) {
+    if (!db2Table->cols[i]->used)
+      continue;
+    ++col_pos;
+    rc = SQLBindCol (pf->hsql, col_pos, db2ColumnCType (db2Table->cols[i]), pf->vals[i], db2Table->cols[i]->val_size, &pf->inds[i]);
+    rc = db2CheckErr(rc, pf->hsql, SQL_HANDLE_STMT, __LINE__, __FILE__);
+    if (rc != SQL_SUCCESS) {
+      /* the statement is unusable now, it must not keep pointers to freed memory */
+      SQLFreeStmt (pf->hsql, SQL_UNBIND);
+      db2PrefetchFree (pf);
+      db2Error_d (FDW_UNABLE_TO_CREATE_EXECUTION, "error executing query: SQLBindCol failed to define result value", db2Message);
+    }
+  }
+  pthread_mutex_init (&pf->mutex, NULL);
+  pthread_cond_init (&pf->cond, NULL);
+
+  i = db2StartThread (db2PrefetchThread, pf, &pf->thread);
+  if (i != 0) {
+    pthread_cond_destroy (&pf->cond);
+    pthread_mutex_destroy (&pf->mutex);
+    SQLFreeStmt (pf->hsql, SQL_UNBIND);
+    db2PrefetchFree (pf);
+    db2Error_d (FDW_UNABLE_TO_CREATE_EXECUTION, "error executing query: failed to start fetch thread", "pthread_create returned %d", i);
+  }
+  session->stmtp->prefetch = pf;
+  if (execute && session->metrics != NULL)
+    ++session->metrics->executions;
+  db2Debug2("  fetch thread started, %d rows or %lu bytes per block", pf->blockrows, (unsigned long) pf->blocksize);
+  db2Debug1("< db2PrefetchStart - returns: 1");
+  return 1;
+}
+
+/** db2PrefetchNext
+ *   Copy the next row fetched by the helper thread into the bound column
+ *   buffers, waiting for the thread if it has not fetched it yet.
+ *   Return 1 if there is a row, else 0; errors of the thread are raised here.
+ */
+int db2PrefetchNext (DB2Session* session) {
+  DB2Prefetch*      pf      = session->stmtp->prefetch;
+  DB2PrefetchBlock* blk     = &pf->block[pf->consume];
+  SQLRETURN         rc      = 0;
+  double            started = 0;
+  int               i;
+
+  db2Debug1("> db2PrefetchNext");
+  /* the flags of the blocks are shared with the thread, only look at them under the mutex */
+  pthread_mutex_lock (&pf->mutex);
+  if (blk->ready && pf->pos >= blk->nrows && blk->rc == SQL_SUCCESS) {
+    /* the block is used up, give it back to the thread and go on with the other one */
+    blk->ready = 0;
+    pthread_cond_broadcast (&pf->cond);
+    pf->consume = 1 - pf->consume;
+    pf->pos     = 0;
+    blk         = &pf->block[pf->consume];
+    pf->next    = blk->data;
+  }
+  if (!blk->ready) {
+    if (session->metrics != NULL)
+      started = db2MetricsNow ();
+    /* a cancel request arriving now cancels the fetch of the thread */
+    db2WaitStart (DB2_WAIT_FETCH);
+    while (!blk->ready)
+      pthread_cond_wait (&pf->cond, &pf->mutex);
+    db2WaitEnd ();
+    if (session->metrics != NULL) {
+      session->metrics->fetch_ms += db2MetricsNow () - started;
+      ++session->metrics->fetch_calls;
+      /* the thread has executed the query by now */
+      session->metrics->execute_ms += pf->exec_ms;
+      pf->exec_ms = 0;
+    }
+  }
+  /* a ready block is not touched by the thread until it is given back */
+  pthread_mutex_unlock (&pf->mutex);
+  if (pf->pos >= blk->nrows) {
+    /* the thread has stopped, find out why */
+    rc = blk->rc;
+    if (rc != SQL_NO_DATA) {
+      rc = db2CheckErr(rc, pf->hsql, SQL_HANDLE_STMT, __LINE__, __FILE__);
+      if (rc != SQL_SUCCESS && rc != SQL_NO_DATA) {
+        if (pf->exec_failed)
+          db2Error_d (err_code == 8177 ? FDW_SERIALIZATION_FAILURE : FDW_UNABLE_TO_CREATE_EXECUTION, "error executing query: SQLExecute failed to execute remote query", db2Message);
+        db2Error_d (err_code == 8177 ? FDW_SERIALIZATION_FAILURE : FDW_UNABLE_TO_CREATE_EXECUTION, "error fetching result: SQLFetchScroll failed to fetch next result row", db2Message);
+      }
+    }
+    db2Debug1("< db2PrefetchNext - returns: 0");
+    return 0;
+  }
+
+  /* unpack the row into the column buffers */
+  for (i = 0; i < pf->db2Table->ncols; ++i) {
+    DB2Column* column = pf->db2Table->cols[i];
+    SQLLEN     ind;
+    size_t     len;
+    if (!column->used)
+      continue;
+    memcpy (&ind, pf->next, sizeof (SQLLEN));
+    pf->next += sizeof (SQLLEN);
+    column->val_null = (int) ind;
+    len = db2PrefetchLen (column, ind);
+    memcpy (column->val, pf->next, len);
+    pf->next += len;
+  }
+  ++pf->pos;
+  if (session->metrics != NULL)
+    ++session->metrics->rows;
+  db2Debug1("< db2PrefetchNext - returns: 1");
+  return 1;
+}
+
+/** db2PrefetchStop
+ *   End the helper thread of a statement handle that is about to be freed.
+ *   A fetch still in progress is cancelled, since nobody will read its rows.
+ */
+void db2PrefetchStop (HdlEntry* handlep) {
+  DB2Prefetch* pf   = handlep->prefetch;
+  int          busy = 0;
+
+  if (pf == NULL)
+    return;
+  db2Debug1("> db2PrefetchStop");
+  pthread_mutex_lock (&pf->mutex);
+  pf->stop = 1;
+  busy     = pf->busy;
+  pthread_cond_broadcast (&pf->cond);
+  pthread_mutex_unlock (&pf->mutex);
+  if (busy)
+    SQLCancel (pf->hsql);
+  pthread_join (pf->thread, NULL);
+  pthread_cond_destroy (&pf->cond);
+  pthread_mutex_destroy (&pf->mutex);
+  db2PrefetchFree (pf);
+  handlep->prefetch = NULL;
+  db2Debug1("< db2PrefetchStop");
+}
+
+/** db2PrefetchThread
+ *   Body of the helper thread: execute the query if asked to,
+ *   then fill the free block, hand it to the backend
+ *   and continue with the other one, until the result is exhausted, a fetch
+ *   fails or the backend stops the thread.
+ *   Runs in a helper thread, see db2StartThread.
+ */
+void* db2PrefetchThread (void* arg) {
+  DB2Prefetch*      pf   = (DB2Prefetch*) arg;
+  DB2PrefetchBlock* blk  = NULL;
+  int               fill = 0;
+
+  if (pf->execute) {
+    double    started = db2MetricsNow ();
+    SQLRETURN rc      = 0;
+
+    pthread_mutex_lock (&pf->mutex);
+    pf->busy = 1;
+    pthread_mutex_unlock (&pf->mutex);
+    rc = SQLExecute (pf->hsql);
+    pthread_mutex_lock (&pf->mutex);
+    pf->busy    = 0;
+    pf->exec_ms = db2MetricsNow () - started;
+    if (rc != SQL_SUCCESS && rc != SQL_SUCCESS_WITH_INFO && rc != SQL_NO_DATA) {
+      /* hand the failure to the backend like a fetch error */
+      pf->exec_failed     = 1;
+      pf->block[0].nrows  = 0;
+      pf->block[0].rc     = rc;
+      pf->block[0].ready  = 1;
+      pthread_cond_broadcast (&pf->cond);
+      pthread_mutex_unlock (&pf->mutex);
+      return NULL;
+    }
+    pthread_mutex_unlock (&pf->mutex);
+  }
+
+  pthread_mutex_lock (&pf->mutex);
+  for (;;) {
+    blk = &pf->block[fill];
+    while (blk->ready && !pf->stop)
+      pthread_cond_wait (&pf->cond, &pf->mutex);
+    if (pf->stop)
+      break;
+    pf->busy = 1;
+    pthread_mutex_unlock (&pf->mutex);
+    db2PrefetchFill (pf, blk);
+    pthread_mutex_lock (&pf->mutex);
+    pf->busy   = 0;
+    blk->ready = 1;
+    pthread_cond_broadcast (&pf->cond);
+    /* end of the result or an error, the backend finds out from blk->rc */
+    if (blk->rc != SQL_SUCCESS)
+      break;
+    fill = 1 - fill;
+  }
+  pthread_mutex_unlock (&pf->mutex);
+  return NULL;
+}
+
+/** db2PrefetchFill
+ *   Fetch rows into "blk" until it is full or the fetch does not return a row.
+ */
+void db2PrefetchFill (DB2Prefetch* pf, DB2PrefetchBlock* blk) {
+  SQLRETURN rc = SQL_SUCCESS;
+  char*     p  = blk->data;
+  int       i;
+
+  blk->nrows = 0;
+  while (blk->nrows < pf->blockrows && (size_t) (p - blk->data) + pf->rowmax <= pf->blocksize) {
+    rc = SQLFetchScroll (pf->hsql, SQL_FETCH_NEXT, 1);
+    if (rc != SQL_SUCCESS && rc != SQL_SUCCESS_WITH_INFO)
+      break;
+    rc = SQL_SUCCESS;
+    for (i = 0; i < pf->db2Table->ncols; ++i) {
+      DB2Column* column = pf->db2Table->cols[i];
+      size_t     len;
+      if (!column->used)
+        continue;
+      memcpy (p, &pf->inds[i], sizeof (SQLLEN));
+      p  += sizeof (SQLLEN);
+      len = db2PrefetchLen (column, pf->inds[i]);
+      memcpy (p, pf->vals[i], len);
+      p  += len;
+    }
+    ++blk->nrows;
+  }
+  blk->used = p - blk->data;
+  blk->rc   = rc;
+}
+
+/** db2PrefetchFree
+ *   Release the buffers of a fetch thread that has ended or never started.
+ */
+void db2PrefetchFree (DB2Prefetch* pf) {
+  int i;
+
+  if (pf->vals != NULL) {
+    for (i = 0; i < pf->db2Table->ncols; ++i)
+      free (pf->vals[i]);
+    free (pf->vals);
+  }
+  free (pf->inds);
+  free (pf->block[0].data);
+  free (pf->block[1].data);
+  free (pf);
+}
+
+/** db2PrefetchLen
+ *   Number of bytes of a column value to keep: nothing for NULL, the value
+ *   with its terminating zero if the indicator holds its length, otherwise
+ *   (truncated or of unknown length) the whole buffer.
+ */
+size_t db2PrefetchLen (DB2Column* column, SQLLEN ind) {
+  if (ind == SQL_NULL_DATA)
+    return 0;
+  if (ind >= 0 && (size_t) ind < column->val_size)
+    return (size_t) ind + 1;
+  return column->val_size;
+}
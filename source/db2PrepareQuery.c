@@ -10,18 +10,20 @@
 extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
 
 /** external prototypes */
-extern void         db2Debug1            (const char* message, ...);
-extern void         db2Debug2            (const char* message, ...);
-extern void         db2Debug3            (const char* message, ...);
 extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
 extern void         db2Error             (db2error sqlstate, const char* message);
 extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
 extern HdlEntry*    db2AllocStmtHdl      (SQLSMALLINT type, DB2ConnEntry* connp, db2error error, const char* errmsg);
 extern SQLSMALLINT  c2param              (SQLSMALLINT fparamType);
 extern char*        param2name           (SQLSMALLINT fparamType);
+extern double       db2MetricsNow        (void);
+extern void         db2Transactional     (DB2ConnEntry* connp);
+extern void         db2WaitStart         (db2WaitEvent event);
+extern void         db2WaitEnd           (void);
 
 /** internal prototypes */
 void                db2PrepareQuery      (DB2Session* session, const char *query, DB2Table* db2Table, unsigned long prefetch);
+SQLSMALLINT         db2ColumnCType       (DB2Column* column);
 
 /** db2PrepareQuery
  *   Prepares an SQL statement for execution.
@@ -37,14 +39,31 @@ void db2PrepareQuery (DB2Session* session, const char *query, DB2Table* db2Table
   int        is_select  = 0;
   int        for_update = 0;
   SQLRETURN  rc         = 0;
+  double     started    = 0;
 
   db2Debug1("> db2PrepareQuery");
+  if (session->metrics != NULL) {
+    started = db2MetricsNow ();
+    ++session->metrics->prepares;
+  }
   db2Debug2("  query   : '%s'",query);
   db2Debug2("  prefetch: %d  ",prefetch);
   /* figure out if the query is FOR UPDATE */
   is_select  = (strncmp (query, "SELECT", 6) == 0);
   for_update = (strstr (query, "FOR UPDATE") != NULL);
 
+  /*
+   * Statements that modify data or keep read locks until commit run in a
+   * unit of work that is ended with the PostgreSQL transaction; plain UR and
+   * CS reads run in autocommit mode. A query without an isolation clause
+   * reads with the default of the connection.
+   */
+  if (!is_select || for_update || strstr (query, " WITH RS") != NULL || strstr (query, " WITH RR") != NULL
+  || (session->connp->read_locks && strstr (query, " WITH UR") == NULL && strstr (query, " WITH CS") == NULL)) {
+    db2Debug3("  remote transaction must be ended");
+    db2Transactional (session->connp);
+  }
+
   /* make sure there is no statement handle stored in "session" */
   if (session->stmtp != NULL) {
     db2Error(FDW_ERROR, "db2PrepareQuery internal error: statement handle is not NULL");
@@ -53,6 +72,7 @@ void db2PrepareQuery (DB2Session* session, const char *query, DB2Table* db2Table
   /* create statement handle */
   session->stmtp = db2AllocStmtHdl(SQL_HANDLE_STMT, session->connp, FDW_UNABLE_TO_CREATE_EXECUTION, "error executing query: failed to allocate statement handle");
   db2Debug2("  session->stmtp->hsql: %d",session->stmtp->hsql);
+  session->stmtp->for_update = for_update;
   /* set prefetch options */
   if (is_select) {
     unsigned long  prefetch_rows = prefetch;
@@ -92,7 +112,9 @@ void db2PrepareQuery (DB2Session* session, const char *query, DB2Table* db2Table
 
   /* prepare the statement */
   db2Debug2("  query to prepare: '%s'",query);
+  db2WaitStart (DB2_WAIT_PREPARE);
   rc = SQLPrepare(session->stmtp->hsql, (SQLCHAR*)query, SQL_NTS);
+  db2WaitEnd ();
   rc = db2CheckErr(rc, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
   if (rc != SQL_SUCCESS) {
     db2Error_d(FDW_UNABLE_TO_CREATE_EXECUTION, "error executing query: SQLPrepare failed to prepare remote query", db2Message);
@@ -102,7 +124,7 @@ void db2PrepareQuery (DB2Session* session, const char *query, DB2Table* db2Table
   col_pos = 0;
   for (i = 0; i < db2Table->ncols; ++i) {
     if (db2Table->cols[i]->used) {
-      SQLSMALLINT fparamType = c2param((SQLSMALLINT)db2Table->cols[i]->colType);
+      SQLSMALLINT fparamType = db2ColumnCType (db2Table->cols[i]);
       /*
        * Unfortunately DB2 handles DML statements with a RETURNING clause
        * quite different from SELECT statements.  In the latter, the result
@@ -112,10 +134,6 @@ void db2PrepareQuery (DB2Session* session, const char *query, DB2Table* db2Table
        * RETURNING clause are handled in db2ExecuteQuery, here we only
        * allocate locators for LOB columns in RETURNING clauses.
        */
-      /* figure out in which format we want the results */
-      if (db2Table->cols[i]->pgtype == UUIDOID) {
-        fparamType = SQL_C_CHAR;
-      }
       db2Debug2("  db2Table->cols[%d]->colName       : '%s' ",i,db2Table->cols[i]->colName);
       db2Debug2("  db2Table->cols[%d]->colSize       : '%ld'",i,db2Table->cols[i]->colSize);
       db2Debug2("  db2Table->cols[%d]->colScale      : '%d' ",i,db2Table->cols[i]->colScale);
@@ -151,5 +169,24 @@ void db2PrepareQuery (DB2Session* session, const char *query, DB2Table* db2Table
     }
   }
 
+  if (session->metrics != NULL)
+    session->metrics->prepare_ms += db2MetricsNow () - started;
   db2Debug1("< db2PrepareQuery");
 }
+
+/** db2ColumnCType
+ *   The C type a result column is bound with.
+ */
+SQLSMALLINT db2ColumnCType (DB2Column* column) {
+  SQLSMALLINT fparamType = c2param((SQLSMALLINT)column->colType);
+
+  /* figure out in which format we want the results */
+  if (column->pgtype == UUIDOID) {
+    fparamType = SQL_C_CHAR;
+  }
+  /* small LOBs are bound with the row rather than through a locator */
+  if (column->lobInline) {
+    fparamType = (column->colType == SQL_BLOB) ? SQL_C_BINARY : SQL_C_CHAR;
+  }
+  return fparamType;
+}
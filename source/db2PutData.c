@@ -0,0 +1,69 @@
+#include <sqlcli1.h>
+#include <postgres_ext.h>
+#include "db2_fdw.h"
+#include "ParamDesc.h"
+
+/** global variables */
+
+/** external variables */
+extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
+
+/** external prototypes */
+extern void         db2free              (void* p);
+extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
+extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
+extern char*        db2LobSlice          (void* lob, long offset, long length, void** slice);
+extern void         db2WaitStart         (db2WaitEvent event);
+extern void         db2WaitEnd           (void);
+extern void         db2CheckInterrupts   (void);
+
+/** local prototypes */
+SQLRETURN           db2PutData           (DB2Session* session, SQLRETURN status);
+
+/** db2PutData
+ *   Send the LOB parameters bound with SQL_DATA_AT_EXEC after SQLExecute
+ *   returned SQL_NEED_DATA.  SQLParamData hands back the ParamDesc used as
+ *   token, whose value is streamed in chunks of db2LobChunkSize bytes.
+ *   Returns the status of the statement execution, or "status" unchanged
+ *   if no data were needed.
+ */
+SQLRETURN db2PutData (DB2Session* session, SQLRETURN status) {
+  SQLPOINTER  token  = NULL;
+  SQLRETURN   rc     = SQL_SUCCESS;
+  ParamDesc*  param  = NULL;
+  void*       slice  = NULL;
+  char*       data   = NULL;
+  long        offset = 0;
+  long        chunk  = 0;
+  db2Debug1("> db2PutData");
+  while (status == SQL_NEED_DATA) {
+    db2WaitStart (DB2_WAIT_EXECUTE);
+    status = SQLParamData (session->stmtp->hsql, &token);
+    db2WaitEnd ();
+    if (status != SQL_NEED_DATA) {
+      break;
+    }
+    param = (ParamDesc*) token;
+    db2Debug2("  streaming %ld bytes for parameter of column %d", param->value_len, param->colnum);
+    offset = 0;
+    do {
+      /* a large LOB must not delay a cancel request */
+      db2CheckInterrupts ();
+      chunk = (param->value_len - offset < db2LobChunkSize) ? param->value_len - offset : db2LobChunkSize;
+      data  = (chunk > 0) ? db2LobSlice (param->value, offset, chunk, &slice) : "";
+      db2WaitStart (DB2_WAIT_EXECUTE);
+      rc    = SQLPutData (session->stmtp->hsql, (SQLPOINTER) data, (SQLLEN) chunk);
+      db2WaitEnd ();
+      if (chunk > 0 && slice != NULL) {
+        db2free (slice);
+      }
+      rc = db2CheckErr (rc, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
+      if (rc != SQL_SUCCESS) {
+        db2Error_d (FDW_UNABLE_TO_CREATE_EXECUTION, "error executing query: SQLPutData failed to send LOB data", db2Message);
+      }
+      offset += chunk;
+    } while (offset < param->value_len);
+  }
+  db2Debug1("< db2PutData - returns: %d", status);
+  return status;
+}
@@ -5,7 +5,6 @@
 #include "db2_fdw.h"
 
 /*+ external prototypes */
-extern void         db2Debug5                 (const char* message, ...);
 
 /** local prototypes */
 void* db2alloc         (const char* type, size_t size);
@@ -8,7 +8,7 @@
 
 /** external prototypes */
 extern void            db2CloseStatement         (DB2Session* session);
-extern void            db2Debug1                 (const char* message, ...);
+extern void            db2QuerySlotRelease       (const char* dbserver);
 
 /** local prototypes */
 void db2ReScanForeignScan(ForeignScanState* node);
@@ -23,6 +23,10 @@ void db2ReScanForeignScan (ForeignScanState* node) {
   db2Debug1("> db2ReScanForeignScan");
   /* close open DB2 statement if there is one */
   db2CloseStatement(fdw_state->session);
+  if (fdw_state->admitted) {
+    db2QuerySlotRelease (fdw_state->dbserver);
+    fdw_state->admitted = 0;
+  }
   /* reset row count to zero */
   fdw_state->rowcount = 0;
   db2Debug1("< db2ReScanForeignScan");
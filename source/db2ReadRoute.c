@@ -0,0 +1,127 @@
+#include <postgres.h>
+#include <utils/memutils.h>
+#include "db2_fdw.h"
+#include "DB2FdwState.h"
+
+/** number of foreign servers whose read endpoint is remembered per transaction */
+#define DB2_READ_ROUTES 16
+
+/** global variables */
+char*               db2ReadRouteServers[DB2_READ_ROUTES]; /* "read_servers" of servers routed in this transaction */
+char*               db2ReadRouteChosen[DB2_READ_ROUTES];  /* endpoint chosen for each of them                      */
+int                 db2ReadRouteCount = 0;
+unsigned int        db2ReadRouteNext  = 0;                /* round robin position of this backend                */
+
+/** external variables */
+extern bool         dml_in_transaction;
+
+/** external prototypes */
+extern int          db2ConnSlotLoad        (const char* dbserver);
+
+/** local prototypes */
+char*               db2ReadServer          (DB2FdwState* fdw_state, bool read_only);
+char*               db2ReadChoose          (const char* servers, int policy);
+void                db2ReadRouteReset      (void);
+
+/** db2ReadServer
+ *   Return the DB2 database a foreign scan connects to.
+ *   Read-only scans of a server with "read_servers" go to one of the read
+ *   endpoints; all scans of one transaction use the same endpoint, so that
+ *   they see a consistent state of the standby.  Scans that lock rows,
+ *   scans of a statement that modifies data ("read_only" false, e.g. the
+ *   source of INSERT ... SELECT or UPDATE ... FROM) and scans in a transaction
+ *   that already modified data stay on "dbserver", so that a transaction
+ *   always reads its own writes and never writes what it read from a
+ *   lagging standby.
+ */
+char* db2ReadServer (DB2FdwState* fdw_state, bool read_only) {
+  MemoryContext oldcxt;
+  char*         chosen = NULL;
+  int           i;
+
+  if (fdw_state->read_servers == NULL || !read_only || dml_in_transaction || strstr (fdw_state->query, "FOR UPDATE") != NULL)
+    return fdw_state->dbserver;
+  db2Debug1("> db2ReadServer(read_servers: '%s')", fdw_state->read_servers);
+  for (i = 0; i < db2ReadRouteCount; ++i) {
+    if (strcmp (db2ReadRouteServers[i], fdw_state->read_servers) == 0) {
+      db2Debug1("< db2ReadServer - returns: '%s' (chosen before)", db2ReadRouteChosen[i]);
+      return pstrdup (db2ReadRouteChosen[i]);
+    }
+  }
+  chosen = db2ReadChoose (fdw_state->read_servers, fdw_state->read_policy);
+  if (db2ReadRouteCount < DB2_READ_ROUTES) {
+    oldcxt = MemoryContextSwitchTo (TopMemoryContext);
+    db2ReadRouteServers[db2ReadRouteCount] = pstrdup (fdw_state->read_servers);
+    db2ReadRouteChosen[db2ReadRouteCount]  = pstrdup (chosen);
+    db2ReadRouteCount++;
+    MemoryContextSwitchTo (oldcxt);
+  }
+  db2Debug1("< db2ReadServer - returns: '%s'", chosen);
+  return chosen;
+}
+
+/** db2ReadChoose
+ *   Pick one endpoint of the comma separated list "servers".
+ *   DB2_READ_LEAST_LOADED takes the endpoint on which the fewest sessions
+ *   run remote queries, which requires db2_fdw in shared_preload_libraries;
+ *   otherwise, and between equally loaded endpoints, they take turns.
+ */
+char* db2ReadChoose (const char* servers, int policy) {
+  char* list   = pstrdup (servers);
+  char* names[DB2_READ_ENDPOINTS];
+  char* token  = NULL;
+  char* saveptr= NULL;
+  int   count  = 0;
+  int   best   = -1;
+  int   load   = 0;
+  int   least  = 0;
+  int   i;
+
+  for (token = strtok_r (list, ",", &saveptr); token != NULL && count < DB2_READ_ENDPOINTS; token = strtok_r (NULL, ",", &saveptr)) {
+    char* end;
+    while (*token == ' ' || *token == '\t')
+      ++token;
+    end = token + strlen (token);
+    while (end > token && (end[-1] == ' ' || end[-1] == '\t'))
+      *--end = '\0';
+    if (*token != '\0')
+      names[count++] = token;
+  }
+  if (count == 0)
+    ereport (ERROR, (errcode (ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE), errmsg ("option \"%s\" contains no DB2 database", OPT_READ_SERVERS)));
+
+  /* start at the next endpoint in turn, so that ties are spread as well */
+  for (i = 0; i < count; ++i) {
+    int idx = (db2ReadRouteNext + i) % count;
+    if (policy != DB2_READ_LEAST_LOADED) {
+      best = idx;
+      break;
+    }
+    load = db2ConnSlotLoad (names[idx]);
+    if (load < 0) {
+      /* no shared memory, nothing to compare */
+      best = idx;
+      break;
+    }
+    if (best < 0 || load < least) {
+      best  = idx;
+      least = load;
+    }
+  }
+  db2ReadRouteNext++;
+  db2Debug2("  db2_fdw::db2ReadChoose: endpoint %d of %d: '%s'", best + 1, count, names[best]);
+  return pstrdup (names[best]);
+}
+
+/** db2ReadRouteReset
+ *   Forget the endpoints chosen by the transaction that just ended.
+ */
+void db2ReadRouteReset (void) {
+  int i;
+
+  for (i = 0; i < db2ReadRouteCount; ++i) {
+    pfree (db2ReadRouteServers[i]);
+    pfree (db2ReadRouteChosen[i]);
+  }
+  db2ReadRouteCount = 0;
+}
@@ -1,4 +1,6 @@
 #include <postgres.h>
+#include <signal.h>
+#include <miscadmin.h>
 #include <tcop/tcopprot.h>
 #include <libpq/pqsignal.h>
 #include <nodes/pathnodes.h>
@@ -6,19 +8,25 @@
 #include <access/heapam.h>
 #include "db2_fdw.h"
 
+/** external variables */
+extern volatile sig_atomic_t db2WaitActive;
+
 /** external prototypes */
 extern void         db2Cancel                 (void);
-extern void         db2Debug1                 (const char* message, ...);
 
 /** local prototypes */
-void db2SetHandlers(void);
-void db2Die        (SIGNAL_ARGS);
+void db2SetHandlers     (void);
+void db2Die             (SIGNAL_ARGS);
+void db2CancelQuery     (SIGNAL_ARGS);
+void db2CheckInterrupts (void);
 
 /** db2SetHandlers
- *   Set signal handler for SIGTERM.
+ *   Set signal handlers for SIGTERM and SIGINT.
+ *   SIGINT is sent for query cancel requests as well as by statement_timeout.
  */
 void db2SetHandlers (void) {
   pqsignal (SIGTERM, db2Die);
+  pqsignal (SIGINT , db2CancelQuery);
 }
 
 /** db2Die
@@ -39,4 +47,29 @@ void db2Die (SIGNAL_ARGS) {
    */
   die (postgres_signal_arg);
   db2Debug1("< db2Die");
-}
\ No newline at end of file
+}
+
+/** db2CancelQuery
+ *   Cancel the running DB2 statement on a query cancel request or statement timeout.
+ *   This is a signal handler function.
+ *   DB2 is only interrupted while the backend waits in a blocking CLI call,
+ *   otherwise the cancel request is noticed by the next CHECK_FOR_INTERRUPTS().
+ *   The DB2 error caused by the cancel is reported as "canceling statement"
+ *   because db2Error_d calls CHECK_FOR_INTERRUPTS() first.
+ */
+void db2CancelQuery (SIGNAL_ARGS) {
+  int save_errno = errno;
+
+  if (db2WaitActive)
+    db2Cancel ();
+  errno = save_errno;
+  /* call the original handler, which sets QueryCancelPending */
+  StatementCancelHandler (postgres_signal_arg);
+}
+
+/** db2CheckInterrupts
+ *   Process pending interrupts, for loops on the DB2 side.
+ */
+void db2CheckInterrupts (void) {
+  CHECK_FOR_INTERRUPTS ();
+}
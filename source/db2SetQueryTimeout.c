@@ -0,0 +1,37 @@
+#include <sqlcli1.h>
+#include <postgres_ext.h>
+#include "db2_fdw.h"
+
+/** global variables */
+
+/** external variables */
+extern char         db2Message[ERRBUFSIZE];/* contains DB2 error messages, set by db2CheckErr()             */
+
+/** external prototypes */
+extern void         db2Error             (db2error sqlstate, const char* message);
+extern void         db2Error_d           (db2error sqlstate, const char* message, const char* detail, ...);
+extern SQLRETURN    db2CheckErr          (SQLRETURN status, SQLHANDLE handle, SQLSMALLINT handleType, int line, char* file);
+
+/** local prototypes */
+void                db2SetQueryTimeout   (DB2Session* session, int timeout);
+
+/** db2SetQueryTimeout
+ *   Let DB2 cancel the prepared statement if it runs longer than "timeout" seconds.
+ *   A timeout of 0 leaves the statement without limit.
+ */
+void db2SetQueryTimeout (DB2Session* session, int timeout) {
+  SQLRETURN rc = 0;
+  db2Debug1("> db2SetQueryTimeout");
+  db2Debug2("  timeout: %d",timeout);
+  if (session->stmtp == NULL) {
+    db2Error (FDW_ERROR, "db2SetQueryTimeout internal error: statement handle is NULL");
+  }
+  if (timeout > 0) {
+    rc = SQLSetStmtAttr(session->stmtp->hsql, SQL_ATTR_QUERY_TIMEOUT, (SQLPOINTER)(SQLLEN)timeout, 0);
+    rc = db2CheckErr(rc, session->stmtp->hsql, session->stmtp->type, __LINE__, __FILE__);
+    if (rc != SQL_SUCCESS) {
+      db2Error_d (FDW_UNABLE_TO_CREATE_EXECUTION, "error executing query: SQLSetStmtAttr failed to set query timeout", db2Message);
+    }
+  }
+  db2Debug1("< db2SetQueryTimeout");
+}
@@ -10,7 +10,6 @@ extern int          sql_initialized;       /* set to "1" as soon as SQLAllocHand
 extern DB2EnvEntry* rootenvEntry;          /* Linked list of handles for cached DB2 connections.            */
 
 /** external prototypes */
-extern void      db2Debug1            (const char* message, ...);
 extern void      db2FreeEnvHdl        (DB2EnvEntry* envp, const char* nls_lang);
 extern void      db2CloseConnections  (void);
 
@@ -0,0 +1,27 @@
+#include <pthread.h>
+#include <signal.h>
+#include <sqlcli1.h>
+#include <postgres_ext.h>
+#include "db2_fdw.h"
+
+/** local prototypes */
+int                 db2StartThread       (void* (*body) (void*), void* arg, pthread_t* thread);
+
+/** db2StartThread
+ *   Start a helper thread that runs "body" with "arg".
+ *   The thread is created with all signals blocked, so that it never runs
+ *   PostgreSQL's signal handlers, and "body" must not call anything but
+ *   DB2 CLI and the C library.
+ *   Returns the result of pthread_create, 0 on success.
+ */
+int db2StartThread (void* (*body) (void*), void* arg, pthread_t* thread) {
+  sigset_t blocked;
+  sigset_t saved;
+  int      rc;
+
+  sigfillset (&blocked);
+  pthread_sigmask (SIG_BLOCK, &blocked, &saved);
+  rc = pthread_create (thread, NULL, body, arg);
+  pthread_sigmask (SIG_SETMASK, &saved, NULL);
+  return rc;
+}
@@ -0,0 +1,346 @@
+#include <postgres.h>
+#include <catalog/pg_authid.h>
+#include <common/md5.h>
+#include <funcapi.h>
+#include <mb/pg_wchar.h>
+#include <miscadmin.h>
+#include <storage/ipc.h>
+#include <storage/lwlock.h>
+#include <storage/shmem.h>
+#include <storage/spin.h>
+#include <utils/acl.h>
+#include <utils/builtins.h>
+#include <utils/hsearch.h>
+#include <utils/memutils.h>
+#include <utils/tuplestore.h>
+#include "db2_fdw.h"
+#include "DB2StatEntry.h"
+
+/** number of columns of db2_fdw_stat_statements */
+#define DB2_STAT_COLS 18
+
+/** global variables */
+int                        db2StatMax         = DEFAULT_STAT_MAX; /* set by db2_fdw.stat_max         */
+bool                       db2TrackStatements = true;             /* set by db2_fdw.track_statements */
+DB2StatShared*             db2StatShared      = NULL;             /* NULL unless loaded at server start */
+HTAB*                      db2StatHash        = NULL;
+#if PG_VERSION_NUM >= 150000
+shmem_request_hook_type    prev_shmem_request_hook = NULL;
+#endif
+shmem_startup_hook_type    prev_shmem_startup_hook = NULL;
+
+/** local prototypes */
+void                db2StatInit            (void);
+Size                db2StatShmemSize       (void);
+void                db2StatShmemRequest    (void);
+void                db2StatShmemStartup    (void);
+bool                db2StatEnabled         (void);
+void                db2StatBegin           (const char* query, DB2Metrics* metrics);
+void                db2StatAbort           (void* arg);
+void                db2StatStore           (const char* query, DB2Metrics* metrics, bool error);
+void                db2StatQueryId         (const char* query, char* queryid);
+DB2StatEntry*       db2StatEntryAlloc      (DB2StatKey* key, const char* query);
+void                db2StatAddTime         (DB2StatTime* time, double value, int64 calls);
+void                db2StatStatements      (FunctionCallInfo fcinfo);
+void                db2StatReset           (void);
+
+/** db2StatInit
+ *   Ask for the shared memory of db2_fdw_stat_statements.
+ *   This is only possible if db2_fdw is in shared_preload_libraries,
+ *   otherwise statement statistics stay disabled.
+ */
+void db2StatInit (void) {
+  db2Debug1("> db2StatInit");
+  if (process_shared_preload_libraries_in_progress) {
+#if PG_VERSION_NUM >= 150000
+    prev_shmem_request_hook = shmem_request_hook;
+    shmem_request_hook      = db2StatShmemRequest;
+#else
+    db2StatShmemRequest ();
+#endif
+    prev_shmem_startup_hook = shmem_startup_hook;
+    shmem_startup_hook      = db2StatShmemStartup;
+  }
+  db2Debug1("< db2StatInit");
+}
+
+/** db2StatShmemSize
+ *   Size of the shared memory needed for db2StatMax statements.
+ */
+Size db2StatShmemSize (void) {
+  return add_size (MAXALIGN (sizeof (DB2StatShared)), hash_estimate_size (db2StatMax, sizeof (DB2StatEntry)));
+}
+
+/** db2StatShmemRequest
+ *   Reserve shared memory and a lock for the statement hash table.
+ */
+void db2StatShmemRequest (void) {
+#if PG_VERSION_NUM >= 150000
+  if (prev_shmem_request_hook)
+    prev_shmem_request_hook ();
+#endif
+  RequestAddinShmemSpace (db2StatShmemSize ());
+  RequestNamedLWLockTranche ("db2_fdw", 1);
+}
+
+/** db2StatShmemStartup
+ *   Create or attach to the statement hash table in shared memory.
+ */
+void db2StatShmemStartup (void) {
+  HASHCTL info;
+  bool    found;
+
+  if (prev_shmem_startup_hook)
+    prev_shmem_startup_hook ();
+
+  LWLockAcquire (AddinShmemInitLock, LW_EXCLUSIVE);
+  db2StatShared = ShmemInitStruct ("db2_fdw stat statements", sizeof (DB2StatShared), &found);
+  if (!found) {
+    db2StatShared->lock = &(GetNamedLWLockTranche ("db2_fdw"))->lock;
+  }
+  memset (&info, 0, sizeof (info));
+  info.keysize   = sizeof (DB2StatKey);
+  info.entrysize = sizeof (DB2StatEntry);
+  db2StatHash    = ShmemInitHash ("db2_fdw stat statements hash", db2StatMax, db2StatMax, &info, HASH_ELEM | HASH_BLOBS);
+  LWLockRelease (AddinShmemInitLock);
+}
+
+/** db2StatEnabled
+ *   Return true if remote statements are tracked in db2_fdw_stat_statements.
+ */
+bool db2StatEnabled (void) {
+  return db2StatShared != NULL && db2TrackStatements;
+}
+
+/** db2StatBegin
+ *   Start tracking a foreign scan or modification that collects its figures in "metrics".
+ *   The call is normally stored when the node ends; if it ends with an error instead,
+ *   it is stored as failed when the executor's memory context goes away.
+ */
+void db2StatBegin (const char* query, DB2Metrics* metrics) {
+  DB2StatCall* call;
+
+  if (!db2StatEnabled ())
+    return;
+  db2Debug1("> db2StatBegin");
+  call                    = (DB2StatCall*) palloc0 (sizeof (DB2StatCall));
+  call->query             = query;
+  call->metrics           = metrics;
+  call->callback.func     = db2StatAbort;
+  call->callback.arg      = (void*) call;
+  MemoryContextRegisterResetCallback (CurrentMemoryContext, &call->callback);
+  db2Debug1("< db2StatBegin");
+}
+
+/** db2StatAbort
+ *   Memory context callback: store a call that did not end normally as failed.
+ */
+void db2StatAbort (void* arg) {
+  DB2StatCall* call = (DB2StatCall*) arg;
+
+  if (!call->metrics->stored && call->metrics->prepares > 0)
+    db2StatStore (call->query, call->metrics, true);
+}
+
+/** db2StatStore
+ *   Add the figures of one call to the statistics of its statement.
+ *   Calls that never executed the statement, like those of a plain EXPLAIN, are not counted.
+ */
+void db2StatStore (const char* query, DB2Metrics* metrics, bool error) {
+  DB2StatKey    key;
+  DB2StatEntry* entry;
+
+  if (metrics->stored || !db2StatEnabled ())
+    return;
+  metrics->stored = 1;
+  if (!error && metrics->executions == 0)
+    return;
+  db2Debug1("> db2StatStore");
+
+  memset (&key, 0, sizeof (key));
+  key.dbid = MyDatabaseId;
+  db2StatQueryId (query, key.queryid);
+
+  /* most calls find their entry and only need the shared lock */
+  LWLockAcquire (db2StatShared->lock, LW_SHARED);
+  entry = (DB2StatEntry*) hash_search (db2StatHash, &key, HASH_FIND, NULL);
+  if (entry == NULL) {
+    LWLockRelease (db2StatShared->lock);
+    LWLockAcquire (db2StatShared->lock, LW_EXCLUSIVE);
+    entry = db2StatEntryAlloc (&key, query);
+  }
+  if (entry != NULL) {
+    SpinLockAcquire (&entry->mutex);
+    db2StatAddTime (&entry->prepare, metrics->prepare_ms, entry->calls);
+    db2StatAddTime (&entry->execute, metrics->execute_ms, entry->calls);
+    db2StatAddTime (&entry->fetch  , metrics->fetch_ms  , entry->calls);
+    entry->calls      += 1;
+    entry->errors     += error ? 1 : 0;
+    entry->executions += metrics->executions;
+    entry->rows       += metrics->rows;
+    entry->bytes      += metrics->bytes;
+    entry->lob_bytes  += metrics->lob_bytes;
+    SpinLockRelease (&entry->mutex);
+  }
+  LWLockRelease (db2StatShared->lock);
+  db2Debug1("< db2StatStore");
+}
+
+/** db2StatQueryId
+ *   Store the MD5 hash of the statement in "queryid" (33 bytes).
+ *   SELECT statements built by createQuery carry it in a leading comment,
+ *   all others are hashed here.
+ */
+void db2StatQueryId (const char* query, char* queryid) {
+#if PG_VERSION_NUM >= 150000
+  const char* errstr = NULL;
+#endif
+
+  if (strncmp (query, "SELECT /*", 9) == 0 && strlen (query) > 43 && strncmp (query + 41, "*/", 2) == 0) {
+    memcpy (queryid, query + 9, 32);
+    queryid[32] = '\0';
+    return;
+  }
+#if PG_VERSION_NUM >= 150000
+  if (!pg_md5_hash (query, strlen (query), queryid, &errstr)) {
+#else
+  if (!pg_md5_hash (query, strlen (query), queryid)) {
+#endif
+    ereport (ERROR, (errcode (ERRCODE_OUT_OF_MEMORY), errmsg ("out of memory")));
+  }
+}
+
+/** db2StatEntryAlloc
+ *   Create the entry for "key", the caller must hold the exclusive lock.
+ *   If the table is full, the entry with the fewest calls is evicted first.
+ *   Returns NULL if no entry could be created.
+ */
+DB2StatEntry* db2StatEntryAlloc (DB2StatKey* key, const char* query) {
+  DB2StatEntry*   entry;
+  DB2StatEntry*   victim = NULL;
+  HASH_SEQ_STATUS status;
+  bool            found;
+  int             len;
+
+  if (hash_get_num_entries (db2StatHash) >= db2StatMax) {
+    hash_seq_init (&status, db2StatHash);
+    while ((entry = (DB2StatEntry*) hash_seq_search (&status)) != NULL) {
+      if (victim == NULL || entry->calls < victim->calls)
+        victim = entry;
+    }
+    if (victim != NULL)
+      hash_search (db2StatHash, &victim->key, HASH_REMOVE, NULL);
+  }
+  entry = (DB2StatEntry*) hash_search (db2StatHash, key, HASH_ENTER_NULL, &found);
+  if (entry != NULL && !found) {
+    memset ((char*) entry + sizeof (DB2StatKey), 0, sizeof (DB2StatEntry) - sizeof (DB2StatKey));
+    SpinLockInit (&entry->mutex);
+    /* do not cut a multibyte character in half */
+    len = pg_mbcliplen (query, strlen (query), DB2_STAT_QUERY_LEN - 1);
+    memcpy (entry->query, query, len);
+    entry->query[len] = '\0';
+  }
+  return entry;
+}
+
+/** db2StatAddTime
+ *   Add the time of one call to "time", "calls" is the number of calls so far.
+ */
+void db2StatAddTime (DB2StatTime* time, double value, int64 calls) {
+  time->total += value;
+  if (calls == 0 || value < time->min)
+    time->min = value;
+  if (calls == 0 || value > time->max)
+    time->max = value;
+}
+
+/** db2StatStatements
+ *   Return the contents of the statement hash table as the result set of
+ *   db2_fdw_stat_statements().  Without pg_read_all_stats, only statements
+ *   of the current database are shown.
+ */
+void db2StatStatements (FunctionCallInfo fcinfo) {
+  ReturnSetInfo*   rsinfo = (ReturnSetInfo*) fcinfo->resultinfo;
+  TupleDesc        tupdesc;
+  Tuplestorestate* tupstore;
+  MemoryContext    oldcontext;
+  HASH_SEQ_STATUS  status;
+  DB2StatEntry*    entry;
+  bool             all_dbs;
+
+  db2Debug1("> db2StatStatements");
+  if (db2StatShared == NULL || db2StatHash == NULL)
+    ereport (ERROR, (errcode (ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE), errmsg ("db2_fdw must be loaded via \"shared_preload_libraries\" to track statements")));
+  if (rsinfo == NULL || !IsA (rsinfo, ReturnSetInfo) || !(rsinfo->allowedModes & SFRM_Materialize))
+    ereport (ERROR, (errcode (ERRCODE_FEATURE_NOT_SUPPORTED), errmsg ("set-valued function called in context that cannot accept a set")));
+  if (get_call_result_type (fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+    elog (ERROR, "return type must be a row type");
+
+  oldcontext         = MemoryContextSwitchTo (rsinfo->econtext->ecxt_per_query_memory);
+  tupstore           = tuplestore_begin_heap (true, false, work_mem);
+  rsinfo->returnMode = SFRM_Materialize;
+  rsinfo->setResult  = tupstore;
+  rsinfo->setDesc    = tupdesc;
+  MemoryContextSwitchTo (oldcontext);
+
+  all_dbs = has_privs_of_role (GetUserId (), ROLE_PG_READ_ALL_STATS);
+
+  LWLockAcquire (db2StatShared->lock, LW_SHARED);
+  hash_seq_init (&status, db2StatHash);
+  while ((entry = (DB2StatEntry*) hash_seq_search (&status)) != NULL) {
+    Datum        values[DB2_STAT_COLS];
+    bool         nulls[DB2_STAT_COLS];
+    DB2StatEntry tmp;
+    int          i = 0;
+
+    if (!all_dbs && entry->key.dbid != MyDatabaseId)
+      continue;
+    /* copy the counters so that the spinlock is held only briefly */
+    SpinLockAcquire (&entry->mutex);
+    tmp = *entry;
+    SpinLockRelease (&entry->mutex);
+
+    memset (nulls, 0, sizeof (nulls));
+    values[i++] = ObjectIdGetDatum (tmp.key.dbid);
+    values[i++] = CStringGetTextDatum (tmp.key.queryid);
+    values[i++] = CStringGetTextDatum (tmp.query);
+    values[i++] = Int64GetDatum (tmp.calls);
+    values[i++] = Int64GetDatum (tmp.errors);
+    values[i++] = Int64GetDatum (tmp.executions);
+    values[i++] = Int64GetDatum (tmp.rows);
+    values[i++] = Int64GetDatum (tmp.bytes);
+    values[i++] = Int64GetDatum (tmp.lob_bytes);
+    values[i++] = Float8GetDatum (tmp.prepare.total);
+    values[i++] = Float8GetDatum (tmp.prepare.min);
+    values[i++] = Float8GetDatum (tmp.prepare.max);
+    values[i++] = Float8GetDatum (tmp.execute.total);
+    values[i++] = Float8GetDatum (tmp.execute.min);
+    values[i++] = Float8GetDatum (tmp.execute.max);
+    values[i++] = Float8GetDatum (tmp.fetch.total);
+    values[i++] = Float8GetDatum (tmp.fetch.min);
+    values[i++] = Float8GetDatum (tmp.fetch.max);
+    Assert (i == DB2_STAT_COLS);
+    tuplestore_putvalues (tupstore, tupdesc, values, nulls);
+  }
+  LWLockRelease (db2StatShared->lock);
+  db2Debug1("< db2StatStatements");
+}
+
+/** db2StatReset
+ *   Remove all entries from the statement hash table.
+ */
+void db2StatReset (void) {
+  HASH_SEQ_STATUS status;
+  DB2StatEntry*   entry;
+
+  db2Debug1("> db2StatReset");
+  if (db2StatShared == NULL || db2StatHash == NULL)
+    ereport (ERROR, (errcode (ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE), errmsg ("db2_fdw must be loaded via \"shared_preload_libraries\" to track statements")));
+  LWLockAcquire (db2StatShared->lock, LW_EXCLUSIVE);
+  hash_seq_init (&status, db2StatHash);
+  while ((entry = (DB2StatEntry*) hash_seq_search (&status)) != NULL) {
+    hash_search (db2StatHash, &entry->key, HASH_REMOVE, NULL);
+  }
+  LWLockRelease (db2StatShared->lock);
+  db2Debug1("< db2StatReset");
+}
@@ -0,0 +1,51 @@
+#include <postgres.h>
+#include <signal.h>
+#include <pgstat.h>
+#if PG_VERSION_NUM >= 140000
+#include <utils/wait_event.h>
+#endif
+#include "db2_fdw.h"
+
+/** global variables */
+/* names shown in pg_stat_activity.wait_event, in the order of db2WaitEvent */
+const char*         db2WaitEventNames[DB2_WAIT_EVENTS] = { "DB2Connect", "DB2Prepare", "DB2Execute", "DB2Fetch", "DB2LobRead", "DB2Commit", "DB2Ping", "DB2ConnectSlot", "DB2QuerySlot" };
+/* wait event ids, registered on first use */
+uint32              db2WaitEventIds[DB2_WAIT_EVENTS];
+/* set while a blocking CLI call is in progress, read by the signal handlers */
+volatile sig_atomic_t db2WaitActive = 0;
+
+/** local prototypes */
+uint32              db2WaitEventInfo     (db2WaitEvent event);
+void                db2WaitStart         (db2WaitEvent event);
+void                db2WaitEnd           (void);
+
+/** db2WaitEventInfo
+ *   Return the wait event to report for "event".
+ *   From PostgreSQL 17 on, every event has its own name in pg_stat_activity,
+ *   older versions only show the generic "Extension" wait event.
+ */
+uint32 db2WaitEventInfo (db2WaitEvent event) {
+#if PG_VERSION_NUM >= 170000
+  if (db2WaitEventIds[event] == 0)
+    db2WaitEventIds[event] = WaitEventExtensionNew (db2WaitEventNames[event]);
+  return db2WaitEventIds[event];
+#else
+  return PG_WAIT_EXTENSION;
+#endif
+}
+
+/** db2WaitStart
+ *   Report that the backend is waiting for DB2 in a blocking CLI call.
+ */
+void db2WaitStart (db2WaitEvent event) {
+  pgstat_report_wait_start (db2WaitEventInfo (event));
+  db2WaitActive = 1;
+}
+
+/** db2WaitEnd
+ *   Report that the blocking CLI call returned.
+ */
+void db2WaitEnd (void) {
+  db2WaitActive = 0;
+  pgstat_report_wait_end ();
+}
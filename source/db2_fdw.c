@@ -18,6 +18,7 @@
 #include <foreign/foreign.h>
 #include <miscadmin.h>
 #include <storage/ipc.h>
+#include <utils/acl.h>
 #include <utils/builtins.h>
 #include <utils/array.h>
 #include <utils/guc.h>
@@ -36,11 +37,21 @@ extern PGDLLEXPORT Datum db2_fdw_handler       (PG_FUNCTION_ARGS);
 extern PGDLLEXPORT Datum db2_fdw_validator     (PG_FUNCTION_ARGS);
 extern PGDLLEXPORT Datum db2_close_connections (PG_FUNCTION_ARGS);
 extern PGDLLEXPORT Datum db2_diag              (PG_FUNCTION_ARGS);
+extern PGDLLEXPORT Datum db2_fdw_stat_statements       (PG_FUNCTION_ARGS);
+extern PGDLLEXPORT Datum db2_fdw_stat_statements_reset (PG_FUNCTION_ARGS);
+extern PGDLLEXPORT Datum db2_fdw_prewarm               (PG_FUNCTION_ARGS);
+extern PGDLLEXPORT Datum db2_fdw_connections           (PG_FUNCTION_ARGS);
+extern PGDLLEXPORT Datum db2_fdw_server_stats          (PG_FUNCTION_ARGS);
 
 PG_FUNCTION_INFO_V1 (db2_fdw_handler);
 PG_FUNCTION_INFO_V1 (db2_fdw_validator);
 PG_FUNCTION_INFO_V1 (db2_close_connections);
 PG_FUNCTION_INFO_V1 (db2_diag);
+PG_FUNCTION_INFO_V1 (db2_fdw_stat_statements);
+PG_FUNCTION_INFO_V1 (db2_fdw_stat_statements_reset);
+PG_FUNCTION_INFO_V1 (db2_fdw_prewarm);
+PG_FUNCTION_INFO_V1 (db2_fdw_connections);
+PG_FUNCTION_INFO_V1 (db2_fdw_server_stats);
 
 /** on-load initializer
  */
@@ -72,7 +83,14 @@ DB2FdwOption valid_options[] = {
 #endif
   {OPT_NO_ENCODING_ERROR, ForeignDataWrapperRelationId, false},
   {OPT_NO_ENCODING_ERROR, ForeignTableRelationId      , false},
-  {OPT_NO_ENCODING_ERROR, AttributeRelationId         , false}
+  {OPT_NO_ENCODING_ERROR, AttributeRelationId         , false},
+  {OPT_ISOLATION_LEVEL  , ForeignServerRelationId     , false},
+  {OPT_ISOLATION_LEVEL  , ForeignTableRelationId      , false},
+  {OPT_QUERY_TIMEOUT    , ForeignServerRelationId     , false},
+  {OPT_QUERY_TIMEOUT    , ForeignTableRelationId      , false},
+  {OPT_MAX_CONCURRENT_QUERIES, ForeignServerRelationId, false},
+  {OPT_READ_SERVERS     , ForeignServerRelationId     , false},
+  {OPT_READ_POLICY      , ForeignServerRelationId     , false}
 };
 
 /** Array to hold the type output functions during table modification.
@@ -83,7 +101,7 @@ regproc* output_funcs;
 
 /** db2_utils
  */
-extern DB2Session*      db2GetSession              (const char* connectstring, char* user, char* password, char* jwt_token, const char* nls_lang, int curlevel);
+extern DB2Session*      db2GetSession              (const char* connectstring, char* user, char* password, char* jwt_token, const char* nls_lang);
 extern void             db2CloseConnections        (void);
 extern void             db2ClientVersion           (DB2Session* session, char* version);
 extern void             db2ServerVersion           (DB2Session* session, char* version);
@@ -124,6 +142,12 @@ extern int              db2GetForeignModifyBatchSize(ResultRelInfo *rinfo);
 /** db2 fdw utilities */
 extern char*           guessNlsLang              (char* nls_lang);
 extern void            exitHook                  (int code, Datum arg);
+extern void            db2StatInit               (void);
+extern void            db2StatStatements         (FunctionCallInfo fcinfo);
+extern void            db2StatReset              (void);
+extern void            db2Connections            (FunctionCallInfo fcinfo);
+extern void            db2ConnSlotInit           (void);
+extern void            db2ServerStats            (FunctionCallInfo fcinfo);
 
 
 /** Foreign-data wrapper handler function: return a struct with pointers
@@ -275,6 +299,75 @@ PGDLLEXPORT Datum db2_fdw_validator (PG_FUNCTION_ARGS) {
                   )
                 );
     }
+    /* check valid values for "query_timeout" and "max_concurrent_queries" */
+    if (strcmp (def->defname, OPT_QUERY_TIMEOUT) == 0 || strcmp (def->defname, OPT_MAX_CONCURRENT_QUERIES) == 0) {
+      char *val = STRVAL(def->arg);
+      char *endptr;
+      long timeout = strtol (val, &endptr, 0);
+      if (val[0] == '\0' || *endptr != '\0' || timeout < 0 || timeout > INT_MAX)
+        ereport ( ERROR
+                , ( errcode (ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE)
+                  , errmsg ("invalid value for option \"%s\"", def->defname)
+                  , errhint ("Valid values in this context are integers between 0 and %d.", INT_MAX)
+                  )
+                );
+    }
+    /* check valid values for "read_servers" */
+    if (strcmp (def->defname, OPT_READ_SERVERS) == 0) {
+      char* val   = STRVAL(def->arg);
+      char* p     = val;
+      int   count = 0;
+      bool  empty = true;
+      for (;; ++p) {
+        if (*p == ',' || *p == '\0') {
+          if (empty)
+            ereport ( ERROR
+                    , ( errcode (ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE)
+                      , errmsg ("invalid value for option \"%s\"", def->defname)
+                      , errhint ("Valid values in this context are comma separated DB2 databases.")
+                      )
+                    );
+          ++count;
+          empty = true;
+          if (*p == '\0')
+            break;
+        } else if (*p != ' ' && *p != '\t') {
+          empty = false;
+        }
+      }
+      if (count > DB2_READ_ENDPOINTS)
+        ereport ( ERROR
+                , ( errcode (ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE)
+                  , errmsg ("invalid value for option \"%s\"", def->defname)
+                  , errhint ("At most %d DB2 databases can be given.", DB2_READ_ENDPOINTS)
+                  )
+                );
+    }
+    /* check valid values for "read_policy" */
+    if (strcmp (def->defname, OPT_READ_POLICY) == 0) {
+      char *val = STRVAL(def->arg);
+      if (pg_strcasecmp (val, "round_robin") != 0 && pg_strcasecmp (val, "least_loaded") != 0) {
+        ereport ( ERROR
+                , ( errcode (ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE)
+                  , errmsg ("invalid value for option \"%s\"", def->defname)
+                  , errhint ("Valid values in this context are: round_robin or least_loaded")
+                  )
+                );
+      }
+    }
+    /* check valid values for "isolation_level" */
+    if (strcmp (def->defname, OPT_ISOLATION_LEVEL) == 0) {
+      char *val = STRVAL(def->arg);
+      if (pg_strcasecmp (val, "ur") != 0 && pg_strcasecmp (val, "cs") != 0
+      &&  pg_strcasecmp (val, "rs") != 0 && pg_strcasecmp (val, "rr") != 0) {
+        ereport ( ERROR
+                , ( errcode (ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE)
+                  , errmsg ("invalid value for option \"%s\"", def->defname)
+                  , errhint ("Valid values in this context are: ur, cs, rs or rr")
+                  )
+                );
+      }
+    }
     #if PG_VERSION_NUM >= 140000
     /* check valid values for "batchsz" */
     if (strcmp (def->defname, OPT_BATCH_SIZE) == 0) {
@@ -403,6 +496,7 @@ PGDLLEXPORT Datum db2_diag (PG_FUNCTION_ARGS) {
     char*               password  = NULL;
     char*               dbserver  = NULL;
     char*               jwt_token = NULL;
+    AclResult           aclresult;
     char srv_version[256];
     char cli_version[256];
 
@@ -420,6 +514,14 @@ PGDLLEXPORT Datum db2_diag (PG_FUNCTION_ARGS) {
     table_close (rel, AccessShareLock);
     /* get the foreign server, the user mapping and the FDW */
     server  = GetForeignServer (srvId);
+    /* connecting to a server requires USAGE on it */
+#if PG_VERSION_NUM >= 160000
+    aclresult = object_aclcheck (ForeignServerRelationId, server->serverid, GetUserId (), ACL_USAGE);
+#else
+    aclresult = pg_foreign_server_aclcheck (server->serverid, GetUserId (), ACL_USAGE);
+#endif
+    if (aclresult != ACLCHECK_OK)
+      aclcheck_error (aclresult, OBJECT_FOREIGN_SERVER, server->servername);
     mapping = GetUserMapping (GetUserId (), srvId);
     wrapper = GetForeignDataWrapper (server->fdwid);
     /* get all options for these objects */
@@ -437,7 +539,7 @@ PGDLLEXPORT Datum db2_diag (PG_FUNCTION_ARGS) {
     /* guess a good NLS_LANG environment setting */
     nls_lang = guessNlsLang (nls_lang);
     /* connect to DB2 database */
-    session = db2GetSession (dbserver, user, password, jwt_token, nls_lang, 1);
+    session = db2GetSession (dbserver, user, password, jwt_token, nls_lang);
     /* get the client version */
 
     db2ClientVersion (session, cli_version);
@@ -451,11 +553,258 @@ PGDLLEXPORT Datum db2_diag (PG_FUNCTION_ARGS) {
   PG_RETURN_TEXT_P (cstring_to_text (version.data));
 }
 
+/** db2_fdw_stat_statements
+ *   Return the cumulative statistics of the remote statements.
+ */
+PGDLLEXPORT Datum db2_fdw_stat_statements (PG_FUNCTION_ARGS) {
+  db2StatStatements (fcinfo);
+  return (Datum) 0;
+}
+
+/** db2_fdw_stat_statements_reset
+ *   Discard the cumulative statistics of the remote statements.
+ */
+PGDLLEXPORT Datum db2_fdw_stat_statements_reset (PG_FUNCTION_ARGS) {
+  elog (DEBUG1, "db2_fdw: reset statement statistics");
+  db2StatReset ();
+  PG_RETURN_VOID ();
+}
+
+/** db2_fdw_prewarm
+ *   Open the DB2 connection for a foreign server and the current user,
+ *   so that the first query does not have to wait for it.
+ *   The connection stays in the cache like any other.
+ */
+PGDLLEXPORT Datum db2_fdw_prewarm (PG_FUNCTION_ARGS) {
+  Name                srvname   = PG_GETARG_NAME (0);
+  ForeignServer*      server    = GetForeignServerByName (NameStr (*srvname), false);
+  UserMapping*        mapping   = NULL;
+  ForeignDataWrapper* wrapper   = NULL;
+  List*               options   = NIL;
+  ListCell*           cell;
+  char*               nls_lang  = NULL;
+  char*               user      = NULL;
+  char*               password  = NULL;
+  char*               dbserver  = NULL;
+  char*               jwt_token = NULL;
+  AclResult           aclresult;
+
+  /* connecting to a server requires USAGE on it */
+#if PG_VERSION_NUM >= 160000
+  aclresult = object_aclcheck (ForeignServerRelationId, server->serverid, GetUserId (), ACL_USAGE);
+#else
+  aclresult = pg_foreign_server_aclcheck (server->serverid, GetUserId (), ACL_USAGE);
+#endif
+  if (aclresult != ACLCHECK_OK)
+    aclcheck_error (aclresult, OBJECT_FOREIGN_SERVER, server->servername);
+  mapping = GetUserMapping (GetUserId (), server->serverid);
+  wrapper = GetForeignDataWrapper (server->fdwid);
+  options = list_concat (options, wrapper->options);
+  options = list_concat (options, server->options);
+  options = list_concat (options, mapping->options);
+  foreach (cell, options) {
+    DefElem *def = (DefElem *) lfirst (cell);
+    nls_lang  = (strcmp (def->defname, OPT_NLS_LANG)  == 0) ? STRVAL(def->arg) : nls_lang;
+    dbserver  = (strcmp (def->defname, OPT_DBSERVER)  == 0) ? STRVAL(def->arg) : dbserver;
+    user      = (strcmp (def->defname, OPT_USER)      == 0) ? STRVAL(def->arg) : user;
+    password  = (strcmp (def->defname, OPT_PASSWORD)  == 0) ? STRVAL(def->arg) : password;
+    jwt_token = (strcmp (def->defname, OPT_JWT_TOKEN) == 0) ? STRVAL(def->arg) : jwt_token;
+  }
+  elog (DEBUG1, "db2_fdw: prewarm connection to foreign server \"%s\"", NameStr (*srvname));
+  pfree (db2GetSession (dbserver, user, password, jwt_token, guessNlsLang (nls_lang)));
+  PG_RETURN_VOID ();
+}
+
+/** db2_fdw_connections
+ *   Return the cached DB2 connections of this backend with their statistics.
+ */
+PGDLLEXPORT Datum db2_fdw_connections (PG_FUNCTION_ARGS) {
+  db2Connections (fcinfo);
+  return (Datum) 0;
+}
+
+/** db2_fdw_server_stats
+ *   Return connections, running queries and admission statistics per DB2 database.
+ */
+PGDLLEXPORT Datum db2_fdw_server_stats (PG_FUNCTION_ARGS) {
+  db2ServerStats (fcinfo);
+  return (Datum) 0;
+}
+
 /** _PG_init
  *   Library load-time initalization.
- *   Sets exitHook() callback for backend shutdown.
+ *   Defines the db2_fdw configuration parameters, reserves shared memory
+ *   for db2_fdw_stat_statements and db2_fdw.max_connections and sets exitHook() callback for backend shutdown.
  */
 void _PG_init (void) {
+  DefineCustomIntVariable ("db2_fdw.trace_level"
+                          ,"Sets the level of db2_fdw trace messages (0 = off, 1 to 5 = DEBUG1 to DEBUG5)."
+                          ,"Trace messages are only written if log_min_messages or client_min_messages allow the DEBUG level as well."
+                          ,&db2TraceLevel
+                          ,0
+                          ,0
+                          ,5
+                          ,PGC_SUSET
+                          ,0
+                          ,NULL
+                          ,NULL
+                          ,NULL
+                          );
+  DefineCustomIntVariable ("db2_fdw.lob_chunk_size"
+                          ,"Sets the number of bytes read from DB2 per call when fetching a LOB."
+                          ,NULL
+                          ,&db2LobChunkSize
+                          ,DEFAULT_LOB_CHUNK_SIZE
+                          ,1024
+                          ,INT_MAX / 2
+                          ,PGC_USERSET
+                          ,GUC_UNIT_BYTE
+                          ,NULL
+                          ,NULL
+                          ,NULL
+                          );
+  DefineCustomIntVariable ("db2_fdw.lob_inline_size"
+                          ,"Sets the declared LOB column size up to which values are fetched with the row."
+                          ,"Larger LOB columns are fetched through a LOB locator.  The value is used when the remote table is described."
+                          ,&db2LobInlineSize
+                          ,DEFAULT_LOB_INLINE_SIZE
+                          ,0
+                          ,INT_MAX / 2
+                          ,PGC_USERSET
+                          ,GUC_UNIT_BYTE
+                          ,NULL
+                          ,NULL
+                          ,NULL
+                          );
+  DefineCustomIntVariable ("db2_fdw.stat_max"
+                          ,"Sets the maximum number of remote statements tracked by db2_fdw_stat_statements."
+                          ,NULL
+                          ,&db2StatMax
+                          ,DEFAULT_STAT_MAX
+                          ,100
+                          ,INT_MAX / 2
+                          ,PGC_POSTMASTER
+                          ,0
+                          ,NULL
+                          ,NULL
+                          ,NULL
+                          );
+  DefineCustomBoolVariable ("db2_fdw.track_statements"
+                           ,"Collects statistics of remote statements in db2_fdw_stat_statements."
+                           ,"Only effective if db2_fdw is loaded via shared_preload_libraries."
+                           ,&db2TrackStatements
+                           ,true
+                           ,PGC_SUSET
+                           ,0
+                           ,NULL
+                           ,NULL
+                           ,NULL
+                           );
+  DefineCustomIntVariable ("db2_fdw.connection_idle_timeout"
+                          ,"Sets the time after which an unused DB2 connection is closed."
+                          ,"Idle connections are closed when the backend next opens a DB2 session; 0 keeps them until the backend exits."
+                          ,&db2ConnIdleTimeout
+                          ,0
+                          ,0
+                          ,INT_MAX
+                          ,PGC_USERSET
+                          ,GUC_UNIT_S
+                          ,NULL
+                          ,NULL
+                          ,NULL
+                          );
+  DefineCustomIntVariable ("db2_fdw.connection_check_interval"
+                          ,"Sets the idle time after which a cached DB2 connection is checked before it is reused."
+                          ,"A connection that does not answer is replaced by a new one; 0 disables the check."
+                          ,&db2ConnCheckInterval
+                          ,DEFAULT_CONN_CHECK_INTERVAL
+                          ,0
+                          ,INT_MAX
+                          ,PGC_USERSET
+                          ,GUC_UNIT_S
+                          ,NULL
+                          ,NULL
+                          ,NULL
+                          );
+  DefineCustomBoolVariable ("db2_fdw.parallel_commit"
+                           ,"Commits or rolls back the remote transactions of several DB2 connections concurrently."
+                           ,"Each SQLEndTran then runs in a helper thread, so the transaction waits for the slowest server instead of all of them in turn."
+                           ,&db2ParallelCommit
+                           ,false
+                           ,PGC_USERSET
+                           ,0
+                           ,NULL
+                           ,NULL
+                           ,NULL
+                           );
+  DefineCustomBoolVariable ("db2_fdw.fetch_thread"
+                           ,"Fetches the rows of foreign scans in a helper thread."
+                           ,"The thread fetches the next block of rows from DB2 while the backend converts the current one."
+                           ,&db2FetchThread
+                           ,false
+                           ,PGC_USERSET
+                           ,0
+                           ,NULL
+                           ,NULL
+                           ,NULL
+                           );
+  DefineCustomBoolVariable ("db2_fdw.eager_execute"
+                           ,"Executes the remote queries of foreign scans when the executor starts."
+                           ,"All remote queries of a plan then run on DB2 at the same time instead of when their scan is first read."
+                           ,&db2EagerExecute
+                           ,false
+                           ,PGC_USERSET
+                           ,0
+                           ,NULL
+                           ,NULL
+                           ,NULL
+                           );
+  DefineCustomBoolVariable ("db2_fdw.async_dml"
+                           ,"Executes INSERTs on foreign tables in a helper thread."
+                           ,"DB2 then inserts a row while the executor produces the next one; errors are reported with the next row or at the end of the statement."
+                           ,&db2AsyncDml
+                           ,false
+                           ,PGC_USERSET
+                           ,0
+                           ,NULL
+                           ,NULL
+                           ,NULL
+                           );
+  DefineCustomIntVariable ("db2_fdw.max_connections"
+                          ,"Sets the maximum number of connections all sessions together open to one DB2 database."
+                          ,"Only effective if db2_fdw is loaded via shared_preload_libraries; 0 means no limit."
+                          ,&db2MaxConnections
+                          ,0
+                          ,0
+                          ,INT_MAX
+                          ,PGC_SIGHUP
+                          ,0
+                          ,NULL
+                          ,NULL
+                          ,NULL
+                          );
+  DefineCustomIntVariable ("db2_fdw.connection_wait_timeout"
+                          ,"Sets the maximum time to wait for a connection to a DB2 database when db2_fdw.max_connections is reached."
+                          ,"After that the statement fails; 0 waits until another session closes a connection."
+                          ,&db2ConnWaitTimeout
+                          ,DEFAULT_CONN_WAIT_TIMEOUT
+                          ,0
+                          ,INT_MAX
+                          ,PGC_USERSET
+                          ,GUC_UNIT_MS
+                          ,NULL
+                          ,NULL
+                          ,NULL
+                          );
+#if PG_VERSION_NUM >= 150000
+  MarkGUCPrefixReserved ("db2_fdw");
+#else
+  EmitWarningsOnPlaceholders ("db2_fdw");
+#endif
+  /* shared memory for statement statistics, if loaded at server start */
+  db2StatInit ();
+  /* shared memory counting the DB2 connections of all sessions */
+  db2ConnSlotInit ();
   /* register an exit hook */
   on_proc_exit (&exitHook, PointerGetDatum (NULL));
 }
@@ -11,18 +11,17 @@
 #include <utils/guc.h>
 #include <utils/syscache.h>
 #include <nodes/pathnodes.h>
+#include <portability/instr_time.h>
 #include <optimizer/optimizer.h>
 #include <access/heapam.h>
+#include <storage/proc.h>
 #include "db2_fdw.h"
 #include "DB2FdwState.h"
 
 /** external prototypes */
-extern void         db2GetLob                 (DB2Session* session, DB2Column* column, int cidx, char** value, long* value_len, unsigned long trunc);
+extern void         db2GetLob                 (DB2Session* session, DB2Column* column, int cidx, char** value, long* value_len, unsigned long trunc, size_t hdrsz);
 extern void         db2Shutdown               (void);
 extern short        c2dbType                  (short fcType);
-extern void         db2Debug1                 (const char* message, ...);
-extern void         db2Debug2                 (const char* message, ...);
-extern void         db2Debug3                 (const char* message, ...);
 extern void*        db2alloc                  (const char* type, size_t size);
 extern void*        db2strdup                 (const char* source);
 extern void         db2free                   (void* p);
@@ -33,6 +32,9 @@ char*               deparseExpr               (DB2Session* session, RelOptInfo*
 char*               deparseConstExpr          (DB2Session* session, RelOptInfo* foreignrel, Const*             expr, const DB2Table* db2Table, List** params);
 char*               deparseParamExpr          (DB2Session* session, RelOptInfo* foreignrel, Param*             expr, const DB2Table* db2Table, List** params);
 char*               deparseVarExpr            (DB2Session* session, RelOptInfo* foreignrel, Var*               expr, const DB2Table* db2Table, List** params);
+char*               deparseTypedParamExpr     (DB2Session* session, RelOptInfo* foreignrel, Expr*              expr, Expr* other, const DB2Table* db2Table, List** params);
+DB2Column*          getVarColumn              (RelOptInfo* foreignrel, Var* expr, const DB2Table* db2Table);
+char*               remoteParamType           (Oid pgtype, const DB2Column* column);
 char*               deparseOpExpr             (DB2Session* session, RelOptInfo* foreignrel, OpExpr*            expr, const DB2Table* db2Table, List** params);
 char*               deparseScalarArrayOpExpr  (DB2Session* session, RelOptInfo* foreignrel, ScalarArrayOpExpr* expr, const DB2Table* db2Table, List** params);
 char*               deparseDistinctExpr       (DB2Session* session, RelOptInfo* foreignrel, DistinctExpr*      expr, const DB2Table* db2Table, List** params);
@@ -48,6 +50,10 @@ char*               guessNlsLang              (char* nls_lang);
 char*               deparseDate               (Datum datum);
 char*               deparseTimestamp          (Datum datum, bool hasTimezone);
 char*               deparseInterval           (Datum datum);
+bool                setNativeParameter        (ParamDesc* param, Datum datum, Oid pgtype, short colType);
+bool                isAsciiString             (const char* s, long len);
+bool                needsEncodingCheck        (const DB2Column* column, const char* value, long value_len);
+int                 db2QueryTimeout           (int timeout);
 void                exitHook                  (int code, Datum arg);
 void                convertTuple              (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trunc_lob) ;
 void                errorContextCallback      (void* arg);
@@ -354,6 +360,101 @@ char* deparseVarExpr           (DB2Session* session, RelOptInfo* foreignrel, Var
   return value;
 }
 
+/** getVarColumn
+ *   Return the DB2 column of a foreign table that "expr" refers to,
+ *   or NULL if it is no column of one of our foreign tables.
+ */
+DB2Column* getVarColumn (RelOptInfo* foreignrel, Var* expr, const DB2Table* db2Table) {
+  const DB2Table* var_table = NULL;
+  int             index;
+  #ifdef JOIN_API
+  if (IS_SIMPLE_REL (foreignrel)) {
+  #endif /* JOIN_API */
+    if (expr->varno == foreignrel->relid && expr->varlevelsup == 0)
+      var_table = db2Table;
+  #ifdef JOIN_API
+  } else {
+    DB2FdwState* joinstate  = (DB2FdwState*) foreignrel->fdw_private;
+    DB2FdwState* outerstate = (DB2FdwState*) joinstate->outerrel->fdw_private;
+    DB2FdwState* innerstate = (DB2FdwState*) joinstate->innerrel->fdw_private;
+    if (expr->varno == outerstate->db2Table->cols[0]->varno && expr->varlevelsup == 0)
+      var_table = outerstate->db2Table;
+    if (expr->varno == innerstate->db2Table->cols[0]->varno && expr->varlevelsup == 0)
+      var_table = innerstate->db2Table;
+  }
+  #endif /* JOIN_API */
+  if (var_table == NULL || expr->varattno <= 0)
+    return NULL;
+  for (index = var_table->ncols - 1; index >= 0; --index) {
+    if (var_table->cols[index]->pgattnum == expr->varattno)
+      return var_table->cols[index];
+  }
+  return NULL;
+}
+
+/** remoteParamType
+ *   Return the DB2 type to cast a parameter of type "pgtype" to when it is
+ *   compared with "column", or NULL if the cast could change the result.
+ *   Only casts that cannot truncate or round the value are used.
+ */
+char* remoteParamType (Oid pgtype, const DB2Column* column) {
+  char* type = NULL;
+  switch (c2dbType (column->colType)) {
+    case DB2_SMALLINT:
+      type = (pgtype == INT2OID) ? "SMALLINT" : NULL;
+    break;
+    case DB2_INTEGER:
+      type = (pgtype == INT2OID || pgtype == INT4OID) ? "INTEGER" : NULL;
+    break;
+    case DB2_BIGINT:
+      type = (pgtype == INT2OID || pgtype == INT4OID || pgtype == INT8OID) ? "BIGINT" : NULL;
+    break;
+    case DB2_DOUBLE:
+    case DB2_FLOAT:
+      type = (pgtype == FLOAT4OID || pgtype == FLOAT8OID) ? "DOUBLE" : NULL;
+    break;
+    case DB2_TYPE_DATE:
+      type = (pgtype == DATEOID) ? "DATE" : NULL;
+    break;
+    case DB2_TYPE_TIMESTAMP:
+      /* PostgreSQL timestamps have microseconds, don't cut them off */
+      if (pgtype == TIMESTAMPOID || pgtype == TIMESTAMPTZOID)
+        type = psprintf ("TIMESTAMP(%d)", (column->colScale > 6) ? column->colScale : 6);
+    break;
+    default:
+    break;
+  }
+  return type;
+}
+
+/** deparseTypedParamExpr
+ *   If "expr" is a parameter compared with the column "other", return a
+ *   marker cast to the column's exact DB2 type, so that DB2 can match the
+ *   predicate to an index on the column.
+ *   Returns NULL if that is not possible; the parameter is then not added.
+ */
+char* deparseTypedParamExpr (DB2Session* session, RelOptInfo* foreignrel, Expr* expr, Expr* other, const DB2Table* db2Table, List** params) {
+  DB2Column*     column = NULL;
+  char*          type   = NULL;
+  StringInfoData result;
+
+  if (expr == NULL || other == NULL || !IsA (expr, Param) || !IsA (other, Var))
+    return NULL;
+  column = getVarColumn (foreignrel, (Var*) other, db2Table);
+  if (column == NULL || (type = remoteParamType (((Param*) expr)->paramtype, column)) == NULL)
+    return NULL;
+  /* the column itself must be translatable, else the parameter would be orphaned */
+  if (deparseVarExpr (session, foreignrel, (Var*) other, db2Table, params) == NULL)
+    return NULL;
+  /* this adds the parameter to the list */
+  if (deparseParamExpr (session, foreignrel, (Param*) expr, db2Table, params) == NULL)
+    return NULL;
+  initStringInfo (&result);
+  appendStringInfo (&result, "CAST (? AS %s)", type);
+  db2Debug2("  typed parameter: %s", result.data);
+  return result.data;
+}
+
 char* deparseOpExpr            (DB2Session* session, RelOptInfo* foreignrel, OpExpr*            expr, const DB2Table* db2Table, List** params) {
   char*     value       = NULL;
   char*     opername    = NULL;
@@ -397,12 +498,21 @@ char* deparseOpExpr            (DB2Session* session, RelOptInfo* foreignrel, OpE
         ||   strcmp (opername, "~~")   == 0 || strcmp (opername, "!~~") == 0 || strcmp (opername, "~~*") == 0 ||   strcmp (opername, "!~~*") == 0 
         ||   strcmp (opername, "^")    == 0 || strcmp (opername, "%")   == 0 || strcmp (opername, "&")   == 0 ||   strcmp (opername, "|/")   == 0
         ||   strcmp (opername, "@")  == 0) {
-          char* left = deparseExpr (session, foreignrel, linitial (expr->args), db2Table, params);
+          /* parameters compared with a column get the column's type */
+          bool  compare = (oprkind == 'b')
+                       && (strcmp (opername, "=")  == 0 || strcmp (opername, "<>") == 0
+                       ||  strcmp (opername, "<")  == 0 || strcmp (opername, ">")  == 0
+                       ||  strcmp (opername, "<=") == 0 || strcmp (opername, ">=") == 0);
+          char* left    = (compare) ? deparseTypedParamExpr (session, foreignrel, linitial (expr->args), lsecond (expr->args), db2Table, params) : NULL;
+          if (left == NULL)
+            left = deparseExpr (session, foreignrel, linitial (expr->args), db2Table, params);
           db2Debug2("  left: %s", left);
           if (left != NULL) {
             if (oprkind == 'b') {
               /* binary operator */
-              char* right = deparseExpr (session, foreignrel, lsecond (expr->args), db2Table, params);
+              char* right = (compare) ? deparseTypedParamExpr (session, foreignrel, lsecond (expr->args), linitial (expr->args), db2Table, params) : NULL;
+              if (right == NULL)
+                right = deparseExpr (session, foreignrel, lsecond (expr->args), db2Table, params);
               db2Debug2("  right: %s", right);
               if (right != NULL) {
                 StringInfoData result;
@@ -1372,6 +1482,109 @@ char* deparseInterval (Datum datum) {
   return s.data;
 }
 
+/** setNativeParameter
+ *   Store an integer or floating point parameter value in binary form in
+ *   the buffer of "param", so that it is bound without a round trip
+ *   through its string representation.
+ *   "colType" is the type of the DB2 column the value is compared with or
+ *   stored in, 0 if there is none.  Floating point values for DECIMAL or
+ *   DECFLOAT columns keep the string form, which DB2 rounds like PostgreSQL.
+ *   Returns false if the value is not stored in binary form.
+ */
+bool setNativeParameter (ParamDesc* param, Datum datum, Oid pgtype, short colType) {
+  if (pgtype == FLOAT4OID || pgtype == FLOAT8OID) {
+    switch (c2dbType (colType)) {
+      case DB2_UNKNOWN_TYPE:
+      case DB2_REAL:
+      case DB2_FLOAT:
+      case DB2_DOUBLE:
+      case DB2_SMALLINT:
+      case DB2_INTEGER:
+      case DB2_BIGINT:
+      break;
+      default:
+        param->native = NATIVE_NONE;
+        return false;
+    }
+  }
+  switch (pgtype) {
+    case INT2OID:
+      param->buf.ival = DatumGetInt16 (datum);
+      param->native   = NATIVE_INT64;
+    break;
+    case INT4OID:
+      param->buf.ival = DatumGetInt32 (datum);
+      param->native   = NATIVE_INT64;
+    break;
+    case INT8OID:
+      param->buf.ival = DatumGetInt64 (datum);
+      param->native   = NATIVE_INT64;
+    break;
+    case OIDOID:
+      param->buf.ival = DatumGetObjectId (datum);
+      param->native   = NATIVE_INT64;
+    break;
+    case FLOAT4OID:
+      param->buf.dval = DatumGetFloat4 (datum);
+      param->native   = NATIVE_DOUBLE;
+    break;
+    case FLOAT8OID:
+      param->buf.dval = DatumGetFloat8 (datum);
+      param->native   = NATIVE_DOUBLE;
+    break;
+    default:
+      param->native   = NATIVE_NONE;
+      return false;
+  }
+  param->value = param->buf.raw;
+  return true;
+}
+
+/** isAsciiString
+ *   Return true if the "len" bytes at "s" are 7-bit ASCII without zero bytes.
+ *   The bulk of the data is checked eight bytes at a time.
+ */
+bool isAsciiString (const char* s, long len) {
+  const uint64 highbits = UINT64CONST (0x8080808080808080);
+  const uint64 lowbits  = UINT64CONST (0x0101010101010101);
+  uint64       chunk;
+  for (; len >= (long) sizeof (chunk); s += sizeof (chunk), len -= sizeof (chunk)) {
+    memcpy (&chunk, s, sizeof (chunk));
+    /* a byte with the high bit set, or a zero byte */
+    if (((chunk | ((chunk - lowbits) & ~chunk)) & highbits) != 0)
+      return false;
+  }
+  for (; len > 0; ++s, --len) {
+    if (*s == '\0' || IS_HIGHBIT_SET (*s))
+      return false;
+  }
+  return true;
+}
+
+/** needsEncodingCheck
+ *   Return true if a string value of "column" has to be verified to be in
+ *   the database encoding.  That is not necessary if DB2 converted it to
+ *   UTF-8 for a UTF-8 database, or if it is plain ASCII.
+ */
+bool needsEncodingCheck (const DB2Column* column, const char* value, long value_len) {
+  if (column->convUtf8 && GetDatabaseEncoding () == PG_UTF8)
+    return false;
+  return !isAsciiString (value, value_len);
+}
+
+/** db2QueryTimeout
+ *   Return the number of seconds DB2 may run a statement: the "query_timeout"
+ *   option or statement_timeout rounded up to seconds, whichever is smaller.
+ *   0 means no limit.
+ */
+int db2QueryTimeout (int timeout) {
+  int stmt_timeout = (StatementTimeout > 0) ? (StatementTimeout + 999) / 1000 : 0;
+
+  if (stmt_timeout > 0 && (timeout == 0 || stmt_timeout < timeout))
+    timeout = stmt_timeout;
+  return timeout;
+}
+
 /** convertTuple
  *   Convert a result row from DB2 stored in db2Table
  *   into arrays of values and null indicators.
@@ -1385,15 +1598,23 @@ void convertTuple (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trun
                        index     = -1;
 //  ErrorContextCallback errcb;
   Oid                  pgtype;
+  instr_time           started;
+  double               lob_ms    = 0;
 
   db2Debug1("> %s::convertTuple",__FILE__);
+  /* LOBs are read during conversion, their time is accounted separately */
+  INSTR_TIME_SET_ZERO (started);
+  if (fdw_state->metrics != NULL) {
+    INSTR_TIME_SET_CURRENT (started);
+    lob_ms = fdw_state->metrics->lob_ms;
+  }
   /* initialize error context callback, install it only during conversions */
 //  errcb.callback = errorContextCallback;
 //  errcb.arg = (void *) fdw_state;
 
   /* assign result values */
   for (j = 0; j < fdw_state->db2Table->npgcols; ++j) {
-    short db2Type;
+    char* lob = NULL;
     db2Debug2("  start processing column %d of %d",j + 1, fdw_state->db2Table->npgcols);
     db2Debug2("  index: %d",index);
     /* for dropped columns, insert a NULL */
@@ -1426,9 +1647,28 @@ void convertTuple (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trun
       case DB2_BLOB:
       case DB2_CLOB: {
         db2Debug3("  DB2_BLOB or DB2CLOB");
-        /* for LOBs, get the actual LOB contents (allocated), truncated if desired */
-        /* the column index is 1 based, whereas index id 0 based, so always add 1 to index when calling db2GetLob, since it does a column based access*/
-        db2GetLob (fdw_state->session, fdw_state->db2Table->cols[index], index+1, &value, &value_len, trunc_lob ? (WIDTH_THRESHOLD + 1) : 0);
+        if (fdw_state->db2Table->cols[index]->lobInline) {
+          /* small LOBs were fetched with the row, the indicator holds the length */
+          value     = fdw_state->db2Table->cols[index]->val;
+          value_len = fdw_state->db2Table->cols[index]->val_null;
+          /* a value that grew beyond the buffer in conversion was truncated (01004) */
+          if (value_len < 0 || (size_t) value_len >= fdw_state->db2Table->cols[index]->val_size)
+            ereport (ERROR, (errcode (ERRCODE_STRING_DATA_RIGHT_TRUNCATION)
+                            ,errmsg ("value of column \"%s\" was truncated in character set conversion", fdw_state->db2Table->cols[index]->pgname)
+                            ,errhint ("Set db2_fdw.lob_inline_size to 0 to fetch the LOB via locator.")));
+          value[value_len] = '\0';
+        } else {
+          /* for LOBs, get the actual LOB contents (allocated), truncated if desired */
+          /* the contents are placed behind room for a varlena header, so that they need not be copied again */
+          /* the column index is 1 based, whereas index id 0 based, so always add 1 to index when calling db2GetLob, since it does a column based access*/
+          db2GetLob (fdw_state->session, fdw_state->db2Table->cols[index], index+1, &lob, &value_len, trunc_lob ? (WIDTH_THRESHOLD + 1) : 0, VARHDRSZ);
+          value = (lob != NULL) ? lob + VARHDRSZ : NULL;
+          /* a truncated CLOB must not end in the middle of a character */
+          if (trunc_lob && value != NULL && c2dbType (fdw_state->db2Table->cols[index]->colType) == DB2_CLOB) {
+            value_len        = pg_mbcliplen (value, value_len, value_len);
+            value[value_len] = '\0';
+          }
+        }
       }
       break;
       case DB2_LONGVARBINARY: {
@@ -1463,6 +1703,9 @@ void convertTuple (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trun
         /* for other data types, db2Table contains the results */
         value     = fdw_state->db2Table->cols[index]->val;
         value_len = fdw_state->db2Table->cols[index]->val_len;
+        /* the indicator holds the length unless the value was truncated */
+        if (value_len == 0 && fdw_state->db2Table->cols[index]->val_null >= 0 && (size_t) fdw_state->db2Table->cols[index]->val_null < fdw_state->db2Table->cols[index]->val_size)
+          value_len = fdw_state->db2Table->cols[index]->val_null;
         value_len = (value_len == 0) ? strlen(value) : value_len;
       }
       break;
@@ -1472,6 +1715,8 @@ void convertTuple (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trun
       db2Debug2("  value    : '%s'", value);
     }
     db2Debug2("  value_len: %ld" , value_len);
+    if (fdw_state->metrics != NULL)
+      fdw_state->metrics->bytes += value_len;
     db2Debug2("  fdw_state->db2Table->cols[%d]->val_null : %d",index,fdw_state->db2Table->cols[index]->val_len );
     db2Debug2("  fdw_state->db2Table->cols[%d]->val_null : %d",index,fdw_state->db2Table->cols[index]->val_null);
     db2Debug2("  fdw_state->db2Table->cols[%d]->pgname   : %s",index,fdw_state->db2Table->cols[index]->pgname  );
@@ -1481,23 +1726,45 @@ void convertTuple (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trun
     /* fill the TupleSlot with the data (after conversion if necessary) */
     if (pgtype == BYTEAOID) {
       /* binary columns are not converted */
-      bytea* result = (bytea*) db2alloc ("bytea", value_len + VARHDRSZ);
-      memcpy (VARDATA (result), value, value_len);
+      bytea* result;
+      if (lob != NULL) {
+        /* the LOB buffer already has room for the header */
+        result = (bytea*) lob;
+        lob    = NULL;
+      } else {
+        result = (bytea*) db2alloc ("bytea", value_len + VARHDRSZ);
+        memcpy (VARDATA (result), value, value_len);
+      }
       SET_VARSIZE (result, value_len + VARHDRSZ);
 
       values[j] = PointerGetDatum (result);
+    } else if (pgtype == TEXTOID
+           || (pgtype == VARCHAROID && (fdw_state->db2Table->cols[index]->pgtypmod < 0 || value_len <= fdw_state->db2Table->cols[index]->pgtypmod - VARHDRSZ))
+           || (pgtype == BPCHAROID  &&  fdw_state->db2Table->cols[index]->pgtypmod < 0)) {
+      /* strings that need neither truncation nor padding are built from the known length */
+      fdw_state->columnindex = index;
+      if (needsEncodingCheck (fdw_state->db2Table->cols[index], value, value_len))
+        (void) pg_verify_mbstr (GetDatabaseEncoding (), value, value_len, fdw_state->db2Table->cols[index]->noencerr == NO_ENC_ERR_TRUE);
+      if (lob != NULL) {
+        /* use the LOB buffer as it is, it has room for the header */
+        SET_VARSIZE (lob, value_len + VARHDRSZ);
+        values[j] = PointerGetDatum (lob);
+        lob       = NULL;
+      } else {
+        values[j] = PointerGetDatum (cstring_to_text_with_len (value, value_len));
+      }
     } else {
-      regproc   typinput;
-      HeapTuple tuple;
       Datum     dat;
       db2Debug2("  pgtype: %d",pgtype);
-      /* find the appropriate conversion function */
-      tuple = SearchSysCache1 (TYPEOID, ObjectIdGetDatum (pgtype));
-      if (!HeapTupleIsValid (tuple)) {
-        elog (ERROR, "cache lookup failed for type %u", pgtype);
+      /* find the appropriate conversion function, once per column */
+      if (fdw_state->db2Table->cols[index]->pginput == InvalidOid) {
+        HeapTuple tuple = SearchSysCache1 (TYPEOID, ObjectIdGetDatum (pgtype));
+        if (!HeapTupleIsValid (tuple)) {
+          elog (ERROR, "cache lookup failed for type %u", pgtype);
+        }
+        fdw_state->db2Table->cols[index]->pginput = ((Form_pg_type) GETSTRUCT (tuple))->typinput;
+        ReleaseSysCache (tuple);
       }
-      typinput = ((Form_pg_type) GETSTRUCT (tuple))->typinput;
-      ReleaseSysCache (tuple);
       db2Debug3("  CStringGetDatum");
       dat = CStringGetDatum (value);
       /* install error context callback */
@@ -1511,7 +1778,7 @@ void convertTuple (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trun
       fdw_state->columnindex = index;
 
       /* for string types, check that the data are in the database encoding */
-      if (pgtype == BPCHAROID || pgtype == VARCHAROID || pgtype == TEXTOID) {
+      if ((pgtype == BPCHAROID || pgtype == VARCHAROID || pgtype == TEXTOID) && needsEncodingCheck (fdw_state->db2Table->cols[index], value, value_len)) {
         db2Debug3("  pg_verify_mbstr");
         (void) pg_verify_mbstr (GetDatabaseEncoding (), value, value_len, fdw_state->db2Table->cols[index]->noencerr == NO_ENC_ERR_TRUE);
       }
@@ -1527,27 +1794,28 @@ void convertTuple (DB2FdwState* fdw_state, Datum* values, bool* nulls, bool trun
         case NUMERICOID:
           db2Debug3("  Calling OidFunctionCall3");
           /* these functions require the type modifier */
-          values[j] = OidFunctionCall3 (typinput, dat, ObjectIdGetDatum (InvalidOid), Int32GetDatum (fdw_state->db2Table->cols[index]->pgtypmod));
+          values[j] = OidFunctionCall3 (fdw_state->db2Table->cols[index]->pginput, dat, ObjectIdGetDatum (InvalidOid), Int32GetDatum (fdw_state->db2Table->cols[index]->pgtypmod));
           break;
         default:
           db2Debug3("  Calling OidFunctionCall1");
           /* the others don't */
-          values[j] = OidFunctionCall1 (typinput, dat);
+          values[j] = OidFunctionCall1 (fdw_state->db2Table->cols[index]->pginput, dat);
       }
       /* uninstall error context callback */
 //      error_context_stack = errcb.previous;
     }
 
-    /* release the data buffer for LOBs */
-    db2Type = c2dbType(fdw_state->db2Table->cols[index]->colType);
-    if (db2Type == DB2_BLOB || db2Type == DB2_CLOB) {
-      if (value != NULL) {
-        db2free (value);
-      } else {
-        db2Debug2("  not freeing value, since it is null");
-      }
+    /* release the data buffer for LOBs unless it became the result */
+    if (lob != NULL) {
+      db2free (lob);
     }
   }
+  if (fdw_state->metrics != NULL) {
+    instr_time elapsed;
+    INSTR_TIME_SET_CURRENT (elapsed);
+    INSTR_TIME_SUBTRACT (elapsed, started);
+    fdw_state->metrics->convert_ms += INSTR_TIME_GET_MILLISEC (elapsed) - (fdw_state->metrics->lob_ms - lob_ms);
+  }
   db2Debug1("< %s::convertTuple",__FILE__);
 }
 
@@ -5,8 +5,6 @@
 #include "db2_fdw.h"
 
 /** external variables */
-extern void   db2Debug4            (const char* message, ...);
-extern void   db2Debug5            (const char* message, ...);
 
 /** local prototypes */
 SQLSMALLINT   c2param              (SQLSMALLINT fparamType);
@@ -0,0 +1,88 @@
+/* db2_fdw upgrade from 18.1.1 to 18.2.0 */
+
+\echo Use "ALTER EXTENSION db2_fdw UPDATE TO '18.2.0'" to load this file. \quit
+
+CREATE FUNCTION db2_fdw_stat_statements(
+  OUT dbid oid,
+  OUT queryid text,
+  OUT query text,
+  OUT calls bigint,
+  OUT errors bigint,
+  OUT executions bigint,
+  OUT rows bigint,
+  OUT bytes bigint,
+  OUT lob_bytes bigint,
+  OUT total_prepare_time double precision,
+  OUT min_prepare_time double precision,
+  OUT max_prepare_time double precision,
+  OUT total_execute_time double precision,
+  OUT min_execute_time double precision,
+  OUT max_execute_time double precision,
+  OUT total_fetch_time double precision,
+  OUT min_fetch_time double precision,
+  OUT max_fetch_time double precision
+) RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT VOLATILE;
+
+COMMENT ON FUNCTION db2_fdw_stat_statements()
+IS 'cumulative statistics of the statements sent to DB2';
+
+CREATE VIEW db2_fdw_stat_statements AS
+  SELECT * FROM db2_fdw_stat_statements();
+
+COMMENT ON VIEW db2_fdw_stat_statements
+IS 'cumulative statistics of the statements sent to DB2';
+
+REVOKE ALL ON FUNCTION db2_fdw_stat_statements() FROM PUBLIC;
+REVOKE ALL ON db2_fdw_stat_statements FROM PUBLIC;
+GRANT EXECUTE ON FUNCTION db2_fdw_stat_statements() TO pg_read_all_stats;
+GRANT SELECT ON db2_fdw_stat_statements TO pg_read_all_stats;
+
+CREATE FUNCTION db2_fdw_stat_statements_reset() RETURNS void
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+
+COMMENT ON FUNCTION db2_fdw_stat_statements_reset()
+IS 'discards the statistics collected in db2_fdw_stat_statements';
+
+REVOKE ALL ON FUNCTION db2_fdw_stat_statements_reset() FROM PUBLIC;
+
+CREATE FUNCTION db2_fdw_prewarm(name) RETURNS void
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+
+COMMENT ON FUNCTION db2_fdw_prewarm(name)
+IS 'opens the DB2 connection for a foreign server ahead of the first query';
+
+CREATE FUNCTION db2_fdw_connections(
+  OUT dbserver text,
+  OUT username text,
+  OUT nls_lang text,
+  OUT connected timestamp with time zone,
+  OUT last_used timestamp with time zone,
+  OUT uses bigint,
+  OUT commits bigint,
+  OUT rollbacks bigint,
+  OUT pings bigint,
+  OUT in_transaction boolean
+) RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT VOLATILE;
+
+COMMENT ON FUNCTION db2_fdw_connections()
+IS 'shows the cached DB2 connections of the current session';
+
+CREATE FUNCTION db2_fdw_server_stats(
+  OUT dbserver text,
+  OUT connections integer,
+  OUT active_queries integer,
+  OUT admitted bigint,
+  OUT queued bigint,
+  OUT total_queue_time double precision
+) RETURNS SETOF record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT VOLATILE;
+
+COMMENT ON FUNCTION db2_fdw_server_stats()
+IS 'shows DB2 connections, running queries and admission statistics of all sessions per DB2 database';
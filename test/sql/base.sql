@@ -37,6 +37,20 @@ insert into sample.org (DEPTNUMB,DEPTNAME,MANAGER,DIVISION,LOCATION) values(42,'
 insert into sample.org (DEPTNUMB,DEPTNAME,MANAGER,DIVISION,LOCATION) values(51,'Plains',140,'Midwest','Dallas');
 insert into sample.org (DEPTNUMB,DEPTNAME,MANAGER,DIVISION,LOCATION) values(66,'Pacific',270,'Western','San Francisco');
 insert into sample.org (DEPTNUMB,DEPTNAME,MANAGER,DIVISION,LOCATION) values(84,'Mountain',290,'Western','Denver');
+-- an aborted subtransaction must not keep rows inserted in the background
+SET db2_fdw.async_dml = on;
+DO $$
+BEGIN
+  BEGIN
+    insert into sample.org (DEPTNUMB,DEPTNAME,MANAGER,DIVISION,LOCATION)
+      select 90 + i, 'Aborted', 100 / (5 - i), 'None', 'Nowhere' from generate_series(1, 5) i;
+  EXCEPTION WHEN division_by_zero THEN
+    NULL;
+  END;
+END;
+$$;
+RESET db2_fdw.async_dml;
+select count(*) from sample.org where DEPTNUMB > 90;
 -- inquire the content
 select * from sample.org;
 select * from sample.sales;
@@ -0,0 +1,22 @@
+\set ECHO all
+CREATE DATABASE regisolation;
+GRANT ALL PRIVILEGES ON DATABASE regisolation to postgres;
+\c regisolation
+-- Install extension
+CREATE EXTENSION IF NOT EXISTS db2_fdw;
+-- isolation_level is one of ur, cs, rs or rr in any case, on the server or the foreign table
+CREATE SERVER isosrv FOREIGN DATA WRAPPER db2_fdw OPTIONS (dbserver 'SAMPLE', isolation_level 'CS');
+ALTER SERVER isosrv OPTIONS (SET isolation_level 'rr');
+CREATE FOREIGN TABLE isotab (id integer) SERVER isosrv OPTIONS (table 'ORG', isolation_level 'ur');
+ALTER FOREIGN TABLE isotab OPTIONS (SET isolation_level 'Rs');
+CREATE SERVER isobad FOREIGN DATA WRAPPER db2_fdw OPTIONS (dbserver 'SAMPLE', isolation_level 'serializable');
+ALTER SERVER isosrv OPTIONS (SET isolation_level 'rc');
+ALTER SERVER isosrv OPTIONS (SET isolation_level '');
+ALTER FOREIGN TABLE isotab OPTIONS (SET isolation_level 'dirty');
+-- none of the failed statements has changed anything
+select count(*) from pg_foreign_server where srvname = 'isobad';
+select srvoptions from pg_foreign_server where srvname = 'isosrv';
+select ftoptions from pg_foreign_table where ftrelid = 'isotab'::regclass;
+-- cleanup
+\c postgres
+DROP DATABASE regisolation;
@@ -0,0 +1,19 @@
+\set ECHO all
+CREATE DATABASE regadmission;
+GRANT ALL PRIVILEGES ON DATABASE regadmission to postgres;
+\c regadmission
+-- Install extension
+CREATE EXTENSION IF NOT EXISTS db2_fdw;
+-- max_concurrent_queries is an integer between 0 (no limit) and 2147483647
+CREATE SERVER admsrv FOREIGN DATA WRAPPER db2_fdw OPTIONS (dbserver 'SAMPLE', max_concurrent_queries '4');
+ALTER SERVER admsrv OPTIONS (SET max_concurrent_queries '0');
+CREATE SERVER admbad FOREIGN DATA WRAPPER db2_fdw OPTIONS (dbserver 'SAMPLE', max_concurrent_queries '-1');
+ALTER SERVER admsrv OPTIONS (SET max_concurrent_queries '-4');
+ALTER SERVER admsrv OPTIONS (SET max_concurrent_queries 'four');
+ALTER SERVER admsrv OPTIONS (SET max_concurrent_queries '2147483648');
+-- none of the failed statements has changed anything
+select count(*) from pg_foreign_server where srvname = 'admbad';
+select srvoptions from pg_foreign_server where srvname = 'admsrv';
+-- cleanup
+\c postgres
+DROP DATABASE regadmission;
@@ -0,0 +1,23 @@
+\set ECHO all
+CREATE DATABASE regtimeout;
+GRANT ALL PRIVILEGES ON DATABASE regtimeout to postgres;
+\c regtimeout
+-- Install extension
+CREATE EXTENSION IF NOT EXISTS db2_fdw;
+-- query_timeout is an integer between 0 and 2147483647, on the server or the foreign table
+CREATE SERVER timeoutsrv FOREIGN DATA WRAPPER db2_fdw OPTIONS (dbserver 'SAMPLE', query_timeout '30');
+ALTER SERVER timeoutsrv OPTIONS (SET query_timeout '0');
+CREATE FOREIGN TABLE timeouttab (id integer) SERVER timeoutsrv OPTIONS (table 'ORG', query_timeout '2147483647');
+CREATE SERVER timeoutbad FOREIGN DATA WRAPPER db2_fdw OPTIONS (dbserver 'SAMPLE', query_timeout '-1');
+ALTER SERVER timeoutsrv OPTIONS (SET query_timeout '-30');
+ALTER SERVER timeoutsrv OPTIONS (SET query_timeout '10s');
+ALTER SERVER timeoutsrv OPTIONS (SET query_timeout '');
+ALTER SERVER timeoutsrv OPTIONS (SET query_timeout '2147483648');
+ALTER FOREIGN TABLE timeouttab OPTIONS (SET query_timeout '-5');
+-- none of the failed statements has changed anything
+select count(*) from pg_foreign_server where srvname = 'timeoutbad';
+select srvoptions from pg_foreign_server where srvname = 'timeoutsrv';
+select ftoptions from pg_foreign_table where ftrelid = 'timeouttab'::regclass;
+-- cleanup
+\c postgres
+DROP DATABASE regtimeout;
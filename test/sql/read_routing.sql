@@ -0,0 +1,24 @@
+\set ECHO all
+CREATE DATABASE regrouting;
+GRANT ALL PRIVILEGES ON DATABASE regrouting to postgres;
+\c regrouting
+-- Install extension
+CREATE EXTENSION IF NOT EXISTS db2_fdw;
+-- read_servers lists up to 16 databases, read_policy is round_robin or least_loaded in any case
+CREATE SERVER routesrv FOREIGN DATA WRAPPER db2_fdw OPTIONS (dbserver 'SAMPLE', read_servers 'STANDBY1, STANDBY2', read_policy 'Least_Loaded');
+ALTER SERVER routesrv OPTIONS (SET read_servers 'S1,S2,S3,S4,S5,S6,S7,S8,S9,S10,S11,S12,S13,S14,S15,S16', SET read_policy 'round_robin');
+-- unknown policies are rejected
+CREATE SERVER routebad FOREIGN DATA WRAPPER db2_fdw OPTIONS (dbserver 'SAMPLE', read_policy 'random');
+ALTER SERVER routesrv OPTIONS (SET read_policy 'round robin');
+ALTER SERVER routesrv OPTIONS (SET read_policy '');
+-- read_servers has no empty entries and at most 16 databases
+CREATE SERVER routebad FOREIGN DATA WRAPPER db2_fdw OPTIONS (dbserver 'SAMPLE', read_servers 'STANDBY1,,STANDBY2');
+ALTER SERVER routesrv OPTIONS (SET read_servers 'STANDBY1,');
+ALTER SERVER routesrv OPTIONS (SET read_servers ' ');
+ALTER SERVER routesrv OPTIONS (SET read_servers 'S1,S2,S3,S4,S5,S6,S7,S8,S9,S10,S11,S12,S13,S14,S15,S16,S17');
+-- none of the failed statements has changed anything
+select count(*) from pg_foreign_server where srvname = 'routebad';
+select srvoptions from pg_foreign_server where srvname = 'routesrv';
+-- cleanup
+\c postgres
+DROP DATABASE regrouting;